@@ -1,37 +1,271 @@
 //
 // File Explanation:
 //
-// Requires 2 inputs 
-// 1. InputFilename
+// Requires 1 input 
+// 1. InputFilename, wildcards join the output files of several runs (e.g. "run_*.root")
+// Optional
+// 2. aggregation: first (default), max or sum
 // 
 // This File Scans the Cherenkov Merged File and determines: 
 // 1. Check if a NRF event causes cherenkov
-// 2. Check if a NRF event was detected
-// 3. Check if a Cherenkov event was detected 
-// 4. Check if a NRF event lead to Cherenkov which was then detected 
+// 2. Check if a NRF event lead to Cherenkov which was then detected 
+//
+// NRFMatData, Cherenkov and DetInfo are written in EventID order, so the events are
+// matched with one streaming merge over the three trees. The EventIDs restart with
+// every run, a run is told apart by its file in the chain and its Seed column, which
+// also separates the runs of a file merged with hadd. The key of an event is the
+// position of its run and the EventID. Returns 1 and writes nothing if the runs
+// cannot be told apart, e.g. a merged file written before the Seed column.
+// Only the rows of the current event are kept in memory.
+// When several rows of one tree belong to the same event they are combined with the aggregation:
+// first (first row), max (row with the max energy) or sum (first row with the summed weight)
 // 
-// The script create a new root file with the Following Structure:
-// TFile**		test_EventCheck.root	
-// TFile*		test_EventCheck.root
+// The script create two new root files with the Following Structure:
+// TFile**		test_NRF_to_Cher.root		nrf_to_cher_tree
+// TFile**		test_NRF_to_Cher_to_Det.root	nrf_to_cher_to_det_tree
+
+// Returns the integer code of name in the code dictionary dictName written by mantis, -1 if not found
+int LookUpCode(TFile *f, const char *dictName, const char *name)
+{
+    TObjArray *dict = 0;
+    f->GetObject(dictName, dict);
+    if(!dict)
+    {
+      std::cerr << "LookUpCode::" << dictName << " not found in " << f->GetName() << std::endl;
+      return -1;
+    }
+    TObject *entry = dict->FindObject(name);
+    return entry ? dict->IndexOf(entry) : -1;
+}
+
+struct EventRow
+{
+    long rank;
+    int eventID;
+    double energy, weight, time;
+};
+
+// chain tree number (input file) and seed of a run
+typedef std::pair<long, int> RunID;
+// position of the run and EventID
+typedef std::pair<long, int> EventKey;
 
-void EventCheck(const char *InputFilename)
+// Appends the runs of a chain in entry order, only the Seed column is read. False if a run is not contiguous
+bool ScanRuns(TChain *tree, std::vector<RunID> &runs)
+{
+    // files written before the Seed column are one run each
+    if(!tree->GetBranch("Seed"))
+    {
+        for(int i=0; i<tree->GetListOfFiles()->GetEntries(); ++i)
+          runs.push_back(RunID(i, 0));
+        return true;
+    }
+    TTreeReader reader(tree);
+    TTreeReaderValue<int> seed(reader, "Seed");
+    std::vector<RunID> seen;
+    while(reader.Next())
+    {
+        RunID run(tree->GetTreeNumber(), *seed);
+        if(!seen.empty() && seen.back() == run)
+          continue;
+        if(std::find(seen.begin(), seen.end(), run) != seen.end())
+        {
+            std::cerr << "EventCheck::Seed " << run.second << " appears in two runs of file " << run.first << std::endl;
+            return false;
+        }
+        seen.push_back(run);
+    }
+    runs.insert(runs.end(), seen.begin(), seen.end());
+    return true;
+}
+
+// Ranks the runs consistently with the run order of every tree (topological sort), false if the orders contradict
+bool OrderRuns(const std::vector<std::vector<RunID> > &runs, std::map<RunID, long> &runRank)
+{
+    std::map<RunID, std::vector<RunID> > next;
+    std::map<RunID, int> nBefore;
+    for(unsigned int i=0; i<runs.size(); ++i)
+      for(unsigned int j=0; j<runs[i].size(); ++j)
+      {
+          nBefore[runs[i][j]];
+          if(j == 0)
+            continue;
+          next[runs[i][j-1]].push_back(runs[i][j]);
+          ++nBefore[runs[i][j]];
+      }
+    std::vector<RunID> ready;
+    for(auto it = nBefore.begin(); it != nBefore.end(); ++it)
+      if(it->second == 0)
+        ready.push_back(it->first);
+    runRank.clear();
+    while(!ready.empty())
+    {
+        RunID run = ready.back();
+        ready.pop_back();
+        long rank = runRank.size();
+        runRank[run] = rank;
+        for(unsigned int k=0; k<next[run].size(); ++k)
+          if(--nBefore[next[run][k]] == 0)
+            ready.push_back(next[run][k]);
+    }
+    if(runRank.size() != nBefore.size())
+    {
+        std::cerr << "EventCheck::The trees list the runs in different orders." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Reads one tree entry by entry and hands out the rows of one event at a time
+class EventStream
+{
+public:
+    EventStream(TChain *tree, const std::map<RunID, long> &rank, const char *timeColumn, const char *selColumn = "", std::vector<int> selCodes = {})
+      : reader(tree), eventID(reader, "EventID"), energy(reader, "Energy"), weight(reader, "Weight"),
+        chain(tree), runRank(rank), done(false), unordered(false), rows(0), codes(selCodes)
+    {
+        tree->SetCacheSize(32*1024*1024);
+        if(TString(timeColumn) != "")
+          time.reset(new TTreeReaderValue<double>(reader, timeColumn));
+        if(!codes.empty())
+          code.reset(new TTreeReaderValue<int>(reader, selColumn));
+        if(tree->GetBranch("Seed"))
+          seed.reset(new TTreeReaderValue<int>(reader, "Seed"));
+        head.rank = -1;
+        head.eventID = -1;
+        Advance();
+    }
+
+    bool Done() const { return done; }
+    EventKey Key() const { return EventKey(head.rank, head.eventID); }
+    // a decreasing key, e.g. a merged file written before the Seed column
+    bool Unordered() const { return unordered; }
+    long Rows() const { return rows; }
+
+    bool NextEvent(std::vector<EventRow> &group)
+    {
+        group.clear();
+        if(done)
+          return false;
+        EventKey key = Key();
+        while(!done && Key() == key)
+        {
+            group.push_back(head);
+            Advance();
+        }
+        return true;
+    }
+
+private:
+    void Advance()
+    {
+        EventKey last = Key();
+        while(reader.Next())
+        {
+            if(code && std::find(codes.begin(), codes.end(), **code) == codes.end())
+              continue;
+            head.rank = runRank.find(RunID(chain->GetTreeNumber(), seed ? **seed : 0))->second;
+            head.eventID = *eventID;
+            if(last.second >= 0 && Key() < last)
+              unordered = true;
+            head.energy = *energy;
+            head.weight = *weight;
+            head.time = time ? **time : 0.;
+            ++rows;
+            return;
+        }
+        done = true;
+    }
+
+    TTreeReader reader;
+    TTreeReaderValue<int> eventID;
+    TTreeReaderValue<double> energy, weight;
+    std::unique_ptr<TTreeReaderValue<double> > time;
+    std::unique_ptr<TTreeReaderValue<int> > code, seed;
+    TChain *chain;
+    const std::map<RunID, long> &runRank;
+    bool done, unordered;
+    long rows;
+    EventRow head;
+    std::vector<int> codes;
+};
+
+EventRow Aggregate(const std::vector<EventRow> &group, const TString &agg)
+{
+    EventRow row = group[0];
+    for(unsigned int i=1; i<group.size(); ++i)
+    {
+        if(agg == "max" && group[i].energy > row.energy)
+          row = group[i];
+        else if(agg == "sum")
+          row.weight += group[i].weight;
+    }
+    return row;
+}
+
+int EventCheck(const char *InputFilename, const char *aggregation="first")
 {
     time_t timer, timer2, time_start, time_end;
     time_start = std::time(&timer);
-    TFile *f = TFile::Open(InputFilename);
+    TString agg = aggregation;
+    if(agg != "first" && agg != "max" && agg != "sum")
+    {
+        std::cerr << "EventCheck::Unknown aggregation " << agg << " choose first, max or sum." << std::endl;
+        return 1;
+    }
+    // the three chains list the same files in the same order, so their tree numbers agree
+    TChain *Cherenkov = new TChain("Cherenkov");
+    TChain *NRF = new TChain("NRFMatData");
+    TChain *DetData = new TChain("DetInfo");
+    Cherenkov->Add(InputFilename);
+    NRF->Add(InputFilename);
+    DetData->Add(InputFilename);
+    if(NRF->GetListOfFiles()->GetEntries() == 0)
+    {
+        std::cerr << "EventCheck::Could not open " << InputFilename << std::endl;
+        return 1;
+    }
+    // runs with the same physics list share the code dictionaries, they are read from the first file
+    TFile *f = TFile::Open(NRF->GetListOfFiles()->At(0)->GetTitle());
+    if(!f || f->IsZombie() || NRF->LoadTree(0) < 0 || Cherenkov->LoadTree(0) < 0 || DetData->LoadTree(0) < 0)
+    {
+        std::cerr << "EventCheck::NRFMatData, Cherenkov or DetInfo TTree not found in " << InputFilename << std::endl;
+        return 1;
+    }
+    std::cout << "EventCheck::Objects Grabbed from " << NRF->GetListOfFiles()->GetEntries() << " file(s)!" << std::endl;
     
-    TTree *Cherenkov, *NRF, *DetData;
-    std::vector<int> cherEventv, nrfEventv, detEventv, nrf_to_cherEvents, cher_to_detEvents, nrf_to_detEvents;
-    std::vector<double> cher_to_detEnergies, cher_to_detWeights, cher_to_detTimes;
-    std::vector<double> nrf_to_detEnergies, nrf_to_detWeights, nrf_to_detTimes;
-    std::vector<double> nrfEnergyv, nrfWeightv, cherEnergyv, cherWeightv;
-    std::vector<double> nrf_to_cherenkov_to_detEvents, nrf_to_cherenkov_to_detNRFEnergies, nrf_to_cherenkov_to_detCherEnergies;
-    std::vector<double> nrf_to_cherenkov_to_detNRFWeights, nrf_to_cherenkov_to_detCherWeights;
-    std::vector<double> nrf_to_cherenkov_to_detNRFTimes, nrf_to_cherenkov_to_detCherTimes;
-    double nrfE,nrfW, cherE, cherW, a, energyNRF, energyCher, weightNRF, weightCher, timeNRF, timeCher;
-    int x, nrf_cher_EventID, index;
+    int scintCode = LookUpCode(f, "CreatorProcessCodes", "Scintillation");
+    int cherCode = LookUpCode(f, "CreatorProcessCodes", "Cerenkov");
+    // a tree can miss runs without rows, the runs are ranked consistently with all three
+    std::vector<std::vector<RunID> > runs(3);
+    std::map<RunID, long> runRank;
+    if(!ScanRuns(NRF, runs[0]) || !ScanRuns(Cherenkov, runs[1]) || !ScanRuns(DetData, runs[2]) || !OrderRuns(runs, runRank))
+    {
+        std::cerr << "EventCheck::The runs of " << InputFilename << " cannot be told apart. No output written." << std::endl;
+        return 1;
+    }
+    // files written before the NRFMatData Time column have no NRF time
+    EventStream nrf(NRF, runRank, NRF->GetBranch("Time") ? "Time" : "");
+    EventStream cher(Cherenkov, runRank, "Time");
+    EventStream det(DetData, runRank, "Time", "CreatorProcess", {scintCode, cherCode});
     
+    // ******************************************************************************************************************************** //
     // Set up Output Trees
+    // ******************************************************************************************************************************** //
+    
+    std::string InputFilenameBase = InputFilename;
+    if(InputFilenameBase.find(".root") < InputFilenameBase.length())
+      InputFilenameBase = InputFilenameBase.substr(0, InputFilenameBase.find(".root"));
+    // run_*.root writes run_all_NRF_to_Cher.root
+    while(InputFilenameBase.find_first_of("*?") < InputFilenameBase.length())
+      InputFilenameBase.replace(InputFilenameBase.find_first_of("*?"), 1, "all");
+    std::string OutFilename = InputFilenameBase + "_NRF_to_Cher.root";
+    std::string OutFilename2 = InputFilenameBase + "_NRF_to_Cher_to_Det.root";
+    
+    int nrf_cher_EventID, a;
+    double nrfE,nrfW, cherE, cherW, energyNRF, energyCher, weightNRF, weightCher, timeNRF, timeCher;
+    
+    TFile *fout = new TFile(OutFilename.c_str(),"recreate");
     TTree *nrf_to_cher_tree = new TTree("nrf_to_cher_tree","NRF Events that Lead to Cherenkov");
     nrf_to_cher_tree->Branch("EventID",&nrf_cher_EventID);
     nrf_to_cher_tree->Branch("NRF_Energy",&nrfE);
@@ -39,6 +273,7 @@ void EventCheck(const char *InputFilename)
     nrf_to_cher_tree->Branch("Cher_Energy",&cherE);
     nrf_to_cher_tree->Branch("Cher_Weight",&cherW);
     
+    TFile *fout2 = new TFile(OutFilename2.c_str(),"recreate");
     TTree *nrf_to_cher_to_det_tree = new TTree("nrf_to_cher_to_det_tree","NRF Events that Lead to Cherenkov that were Detected");
     nrf_to_cher_to_det_tree->Branch("EventID",&a);
     nrf_to_cher_to_det_tree->Branch("EnergyNRF",&energyNRF);
@@ -48,287 +283,88 @@ void EventCheck(const char *InputFilename)
     nrf_to_cher_to_det_tree->Branch("TimeNRF",&timeNRF);
     nrf_to_cher_to_det_tree->Branch("TimeCher",&timeCher);
     
-    // Grab objects
-    f->cd();
-    f->GetObject("Cherenkov",Cherenkov);
-    f->GetObject("NRFMatData",NRF);
-    f->GetObject("DetInfo",DetData);
-    
-    Cherenkov->SetEstimate(-1);
-    NRF->SetEstimate(-1);
-    DetData->SetEstimate(-1);
-    
-    std::cout << "EventCheck::Objects Grabbed!" << std::endl;
-    
-    // ******************************************************************************************************************************** //
-    // Variables Declared Objects Set up
-    // ******************************************************************************************************************************** //
-    
     // ******************************************************************************************************************************** //
-    // Grab Events
+    // Join NRF, Cherenkov and Detected Events
     // ******************************************************************************************************************************** //
     
-    // Grab Cherenkov Events
-    G4int n = Cherenkov->Draw("EventID:Energy:Weight","","goff");
-    std::cout << "Cherenkov Entries: " << n << std::endl;
-    Double_t *cherEvent = Cherenkov->GetVal(0);
-    Double_t *cherEnergy = Cherenkov->GetVal(1);
-    Double_t *cherWeight = Cherenkov->GetVal(2);
-
-    for(int i=0;i<n;i++)
-    {
-      cherEventv.push_back((int)cherEvent[i]);
-    }
-      
-    // Grab NRF Events
-    Int_t n1 = NRF->Draw("EventID:Energy:Weight","","goff");
-    std::cout << "NRF Entries: " << n1 << std::endl;
-    Double_t *nrfEvent = NRF->GetVal(0);
-    Double_t *nrfEnergy = NRF->GetVal(1);
-    Double_t *nrfWeight = NRF->GetVal(2);
-
-    for(int i=0;i<n1;i++)
+    std::cout << "Joining NRF, Cherenkov and Detected Events with " << agg << " aggregation..." << std::endl;
+    std::vector<EventRow> nrfGroup, cherGroup, detGroup;
+    while(!nrf.Done() && !cher.Done() && !nrf.Unordered() && !cher.Unordered() && !det.Unordered())
     {
-        nrfEventv.push_back((int)nrfEvent[i]);
-    }
-    
-    
-    // Grab DetInfo Events
-    Int_t n2 = DetData->Draw("EventID:Energy:Weight:Time","DetectionProcess == \"Det\"","goff");
-    std::cout << "Total Number of Detected entries: " << n2 << std::endl;  
-    Double_t *detEvent = DetData->GetVal(0);
-    Double_t *detEnergy = DetData->GetVal(1);
-    Double_t *detWeight = DetData->GetVal(2);
-    Double_t *time = DetData->GetVal(3);
-
-    for(int i=0;i<n2;i++)
-    {
-        detEventv.push_back((int)detEvent[i]);
-    }
-    
-    std::cout << "All Events grabbed." << std::endl;
-    
-    // ******************************************************************************************************************************** //
-    // Determine if NRF Lead to Cherenkov
-    // ******************************************************************************************************************************** //
-    
-    if(n != 0 && n1 != 0)
-    {
-      G4cout << "Finding NRF Events that Caused Cherenkov..." << std::endl;
-      // if Cherenkov has more entries search with nrf events
-      if(n1 < n)
-      {
-          std::cout << "Cherenkov has more entries than NRF. Searching NRF Events..." << std::endl;
-          for(int i=0;i<n1;i++)
-          {
-              x = nrfEventv[i];
-              auto exists = std::find(cherEventv.begin(),cherEventv.end(), x);
-
-              if(exists != cherEventv.end())
-              {
-                  index = exists - cherEventv.begin();
-                  nrf_to_cherEvents.push_back(x);
-                  nrfEnergyv.push_back(nrfEnergy[i]);
-                  nrfWeightv.push_back(nrfWeight[i]);
-                  cherEnergyv.push_back(cherEnergy[index]);
-                  cherWeightv.push_back(cherWeight[index]);
-              }
-          }
-      }
-      // Else NRF has more entries search with cherenkov events
-      else
-      {
-          std::cout << "NRF has more entries than Cherenkov. Searching Cherenkov Events..." << std::endl;
-          for(int i=0;i<n;i++)
-          {
-              x = cherEventv[i];
-              auto exists = std::find(nrfEventv.begin(),nrfEventv.end(), x);
-
-              if(exists != nrfEventv.end())
-              {
-                  index = exists - nrfEventv.begin();
-                  nrf_to_cherEvents.push_back(x);
-                  cherEnergyv.push_back(cherEnergy[i]);
-                  cherWeightv.push_back(cherWeight[i]);
-                  nrfEnergyv.push_back(nrfEnergy[index]);
-                  nrfWeightv.push_back(nrfWeight[index]);
-              }
-          }
-      }
-
-      std::cout << std::endl << "NRF to Cherenkov Number of Events Found: " << nrf_to_cherEvents.size() << std::endl;
-    }
-    
-    // ******************************************************************************************************************************** //
-    // Determine if Cherenkov or NRF Lead to Detection Event
-    // ******************************************************************************************************************************** //
-    if(n2 > 0)
-    {
-      for(int i=0;i<n2;i++)
-      {
-          // Check to see if Cherenkov Event ID matches Det Event ID
-          x = detEventv[i];
-          auto exists = std::find(cherEventv.begin(), cherEventv.end(),x);
-          if(exists != cherEventv.end())
-          {
-              index = exists - cherEventv.begin();
-              cher_to_detEvents.push_back(x);
-              cher_to_detEnergies.push_back(detEnergy[index]);
-              cher_to_detWeights.push_back(detWeight[index]);
-              cher_to_detTimes.push_back(time[index]);
-          }
-          // Check to see if NRF Event ID matches Det Event ID
-          exists = std::find(nrfEventv.begin(),nrfEventv.end(),x);
-          if(exists != nrfEventv.end())
-          {
-              index = exists - nrfEventv.begin();
-              nrf_to_detEvents.push_back(x);
-              nrf_to_detEnergies.push_back(detEnergy[index]);
-              nrf_to_detWeights.push_back(detWeight[index]);
-              nrf_to_detTimes.push_back(time[index]);
-          }
-      }
-
-      std::cout << std::endl << "Cherenkov Events lead to Detection: " << cher_to_detEvents.size() << std::endl;
-      std::cout << "NRF Events Lead to Detection: " << nrf_to_detEvents.size() << std::endl;
-    
-    
-      // ******************************************************************************************************************************** //
-      // Determine if NRF and Cherenkov lead to Detection Event
-      // ******************************************************************************************************************************** //
-
-      // Check to see if cherenkov detected ID and nrf detected ID match
-      // Check if more cherenkov events of nrf events lead to detection if cherenkov > nrf then look at nrf->Detected events
-      if(cher_to_detEvents.size() > nrf_to_detEvents.size())
-      {
-          std::cout << "More Cherenkov Events than nrf events lead to detection. Checking NRF Detected Events..." << std::endl;
-          for(int i=0;i<nrf_to_detEvents.size();i++)
-          {
-              x = nrf_to_detEvents[i];
-              auto exists = std::find(cher_to_detEvents.begin(), cher_to_detEvents.end(),x);
-              if(exists != cher_to_detEvents.end())
-              {
-                  index = exists - cher_to_detEvents.begin();
-                  nrf_to_cherenkov_to_detEvents.push_back(x);
-                  nrf_to_cherenkov_to_detNRFEnergies.push_back(nrf_to_detEnergies[i]);
-                  nrf_to_cherenkov_to_detCherEnergies.push_back(cher_to_detEnergies[index]);
-                  nrf_to_cherenkov_to_detNRFWeights.push_back(nrf_to_detWeights[i]);
-                  nrf_to_cherenkov_to_detCherWeights.push_back(cher_to_detWeights[index]);
-                  nrf_to_cherenkov_to_detNRFTimes.push_back(nrf_to_detTimes[i]);
-                  nrf_to_cherenkov_to_detCherTimes.push_back(cher_to_detTimes[index]);
-              }
-          }
-      }
-      else if(nrf_to_detEvents.size() > cher_to_detEvents.size())
-      {
-          std::cout << "More NRF Events than Cherenkov events lead to detection. Checking Cherenkov Events..." << std::endl;
-          for(int i=0;i<cher_to_detEvents.size();i++)
-          {
-              x = cher_to_detEvents[i];
-              auto exists = std::find(nrf_to_detEvents.begin(), nrf_to_detEvents.end(),x);
-              if(exists != nrf_to_detEvents.end())
-              {
-                  index = exists - nrf_to_detEvents.begin();
-                  nrf_to_cherenkov_to_detEvents.push_back(x);
-                  nrf_to_cherenkov_to_detNRFEnergies.push_back(nrf_to_detEnergies[index]);
-                  nrf_to_cherenkov_to_detCherEnergies.push_back(cher_to_detEnergies[i]);
-                  nrf_to_cherenkov_to_detNRFWeights.push_back(nrf_to_detWeights[index]);
-                  nrf_to_cherenkov_to_detCherWeights.push_back(cher_to_detWeights[i]);
-                  nrf_to_cherenkov_to_detNRFTimes.push_back(nrf_to_detTimes[index]);
-                  nrf_to_cherenkov_to_detCherTimes.push_back(cher_to_detTimes[i]);
-              }
-          }
-      }
-
-      std::cout << std::endl << "NRF Events Leading to Cherenkov Leading to Detection: " << nrf_to_cherenkov_to_detEvents.size() << std::endl;
+        // skip the events of the tree that is behind
+        if(nrf.Key() < cher.Key())
+        {
+            nrf.NextEvent(nrfGroup);
+            continue;
+        }
+        if(cher.Key() < nrf.Key())
+        {
+            cher.NextEvent(cherGroup);
+            continue;
+        }
+        
+        EventKey key = nrf.Key();
+        nrf.NextEvent(nrfGroup);
+        cher.NextEvent(cherGroup);
+        EventRow nrfRow = Aggregate(nrfGroup, agg);
+        EventRow cherRow = Aggregate(cherGroup, agg);
+        
+        nrf_cher_EventID = key.second;
+        nrfE = nrfRow.energy;
+        nrfW = nrfRow.weight;
+        cherE = cherRow.energy;
+        cherW = cherRow.weight;
+        nrf_to_cher_tree->Fill();
+        
+        while(!det.Done() && det.Key() < key)
+          det.NextEvent(detGroup);
+        if(!det.Done() && det.Key() == key)
+        {
+            det.NextEvent(detGroup);
+            EventRow detRow = Aggregate(detGroup, agg);
+            a = key.second;
+            energyNRF = nrfRow.energy;
+            energyCher = cherRow.energy;
+            weightNRF = nrfRow.weight;
+            weightCher = cherRow.weight;
+            timeNRF = nrfRow.time;
+            timeCher = detRow.time;
+            nrf_to_cher_to_det_tree->Fill();
+        }
     }
     
-    // ******************************************************************************************************************************** //
-    // Fill TTrees
-    // ******************************************************************************************************************************** //
-    if(n > 0 && n1 > 0)
+    // a partial join is never written
+    if(nrf.Unordered() || cher.Unordered() || det.Unordered())
     {
-        std::cout << "Filling NRF to Cherenkov Tree..." << std::endl;
-      // Fill nrf_to_cher_tree
-      for(int i=0;i<nrf_to_cherEvents.size();i++)
-      {
-          nrf_cher_EventID = nrf_to_cherEvents[i];
-          nrfE = nrfEnergyv[i];
-          nrfW = nrfWeightv[i];
-          cherE = cherEnergyv[i];
-          cherW = cherWeightv[i];
-          nrf_to_cher_tree->Fill();
-      }
+        std::cerr << "EventCheck::The EventIDs of a run are not increasing, the file was merged from files written before"
+                  << " the Seed column or from runs with the same seed. Join the unmerged output files instead (\"run_*.root\")."
+                  << " No output written." << std::endl;
+        fout->Close();
+        fout2->Close();
+        gSystem->Unlink(OutFilename.c_str());
+        gSystem->Unlink(OutFilename2.c_str());
+        return 1;
     }
     
-    if(n2 > 0)
-    {
-        std::cout << "Filling NRF to Cherenkov to Detected Tree..." << std::endl;
-      // Fill nrf_to_cher_to_det_tree
-      for(int i=0;i<nrf_to_cherenkov_to_detEvents.size();i++)
-      {
-          a = nrf_to_cherenkov_to_detEvents[i];
-          energyNRF = nrf_to_cherenkov_to_detNRFEnergies[i];
-          energyCher = nrf_to_cherenkov_to_detCherEnergies[i];
-          weightNRF = nrf_to_cherenkov_to_detNRFWeights[i];
-          weightCher = nrf_to_cherenkov_to_detCherWeights[i];
-          timeNRF = nrf_to_cherenkov_to_detNRFTimes[i];
-          timeCher = nrf_to_cherenkov_to_detCherTimes[i];
-          nrf_to_cher_to_det_tree->Fill();
-      }
-    }
+    std::cout << "NRF Entries: " << nrf.Rows() << " Cherenkov Entries: " << cher.Rows() << " Detected Entries: " << det.Rows() << std::endl;
+    std::cout << "NRF to Cherenkov Number of Events Found: " << nrf_to_cher_tree->GetEntries() << std::endl;
+    std::cout << "NRF Events Leading to Cherenkov Leading to Detection: " << nrf_to_cher_to_det_tree->GetEntries() << std::endl;
     
     // ******************************************************************************************************************************** //
     // Write TTrees to OutFile
     // ******************************************************************************************************************************** //
     
-    // Write to file
-    std::string FinalOutName = InputFilenameBase;
-    std::string FinalOutName2 = InputFilenameBase;
-    FinalOutName = FinalOutName + "_NRF_to_Cher";
-    FinalOutName2 = FinalOutName2 + "_NRF_to_Cher_to_Det";
-    if(chopState)
-    {
-        FinalOutName = FinalOutName + "On.root";
-        FinalOutName2 = FinalOutName2 + "On.root";
-    }
-    else
-    {
-        FinalOutName = FinalOutName + "Off.root";
-        FinalOutName2 = FinalOutName2 + "Off.root";
-    }
-    const char* OutFilename = FinalOutName.c_str();
-    const char* OutFilename2 = FinalOutName2.c_str();
-    
-    TFile *fout = new TFile(OutFilename,"recreate");
     fout->cd();
-    
-    if(nrf_to_cherEvents.size() > 0)
-    {
-        nrf_to_cher_tree->Write();
-        std::cout << "NRF to Cherenkov Events Written to file: " << OutFilename << std::endl;
-    }
-    else
-    {
-        std::cout << OutFilename << " not written to File!" << std::endl << std::endl;
-    }
+    nrf_to_cher_tree->Write();
     fout->Close();
+    std::cout << "NRF to Cherenkov Events Written to file: " << OutFilename << std::endl;
     
-    TFile *fout2 = new TFile(OutFilename2,"recreate");
     fout2->cd();
-    
-    if(nrf_to_cherenkov_to_detEvents.size() > 0)
-    {
-        nrf_to_cher_to_det_tree->Write();
-        std::cout << "NRF to Cherenkov to Detected Events Written to file: " << OutFilename2 << std::endl;
-    }
-    else
-    {
-        std::cout << OutFilename2 << " not written to File!" << std::endl << std::endl;
-    }
-        
+    nrf_to_cher_to_det_tree->Write();
     fout2->Close();
+    std::cout << "NRF to Cherenkov to Detected Events Written to file: " << OutFilename2 << std::endl;
+    
     time_end = std::time(&timer2);
     std::cout << "Event Check took: " << std::difftime(time_end, time_start) << " seconds!" << std::endl;
-
+    return 0;
 }
@@ -18,6 +18,19 @@
 // entries, weighted sums, and Z-Scores.
 //
 
+// Returns the named histogram, projecting it when mantis wrote it with /output/binning sparse
+TH1D* GetHisto(TFile *f, const char* name)
+{
+    TObject *obj = f->Get(name);
+    if(obj && obj->InheritsFrom(THnSparse::Class()))
+    {
+        TH1D *h = ((THnSparse*) obj)->Projection(0);
+        h->SetName(name);
+        return h;
+    }
+    return (TH1D*) obj;
+}
+
 void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn = "NA", std::string WeightOff = "NA")
 {
     TFile *onFile, *offFile, *weightOnFile, *weightOffFile;
@@ -104,19 +117,19 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
     std::cout << "*************************************" << std::endl << std::endl;
     // Chopper On Analysis
     onFile->cd();
-    onFile->GetObject("ChopperIn_Weighted",ChopInOn);
+    ChopInOn = GetHisto(onFile, "ChopperIn_Weighted");
     weighted_sum = ChopInOn->Integral();
     ChopInOn->Print();
-    onFile->GetObject("ChopperOut_Weighted",ChopOutOn);
+    ChopOutOn = GetHisto(onFile, "ChopperOut_Weighted");
     ChopOutOn->Print();
     weighted_sum2 = ChopOutOn->Integral();
 
     // Chopper Off Analysis
     offFile->cd();
-    offFile->GetObject("ChopperIn_Weighted",ChopInOff);
+    ChopInOff = GetHisto(offFile, "ChopperIn_Weighted");
     weighted_sum3 = ChopInOff->Integral();
     ChopInOff->Print();
-    offFile->GetObject("ChopperOut_Weighted",ChopOutOff);
+    ChopOutOff = GetHisto(offFile, "ChopperOut_Weighted");
     weighted_sum4 = ChopOutOff->Integral();
     ChopOutOff->Print();
 
@@ -131,10 +144,10 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
     std::cout << "*************************************" << std::endl << std::endl;
     // Chopper On Analysis
     onFile->cd();
-    onFile->GetObject("IntObjIn",IntObjInOn);
-    onFile->GetObject("IntObjOut",IntObjOutOn);
-    onFile->GetObject("NRFIntObjIn",IntNRFInOn);
-    onFile->GetObject("NRFIntObjOut",IntNRFOutOn);
+    IntObjInOn = GetHisto(onFile, "IntObjIn");
+    IntObjOutOn = GetHisto(onFile, "IntObjOut");
+    IntNRFInOn = GetHisto(onFile, "NRFIntObjIn");
+    IntNRFOutOn = GetHisto(onFile, "NRFIntObjOut");
     weighted_sum = IntObjInOn->Integral();
     IntObjInOn->Print();
     weighted_sum2 = IntObjOutOn->Integral();
@@ -146,10 +159,10 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
 
     // Chopper Off Analysis
     offFile->cd();
-    offFile->GetObject("IntObjIn",IntObjInOff);
-    offFile->GetObject("IntObjOut",IntObjOutOff);
-    offFile->GetObject("NRFIntObjIn",IntNRFInOff);
-    offFile->GetObject("NRFIntObjOut",IntNRFOutOff);
+    IntObjInOff = GetHisto(offFile, "IntObjIn");
+    IntObjOutOff = GetHisto(offFile, "IntObjOut");
+    IntNRFInOff = GetHisto(offFile, "NRFIntObjIn");
+    IntNRFOutOff = GetHisto(offFile, "NRFIntObjOut");
     weighted_sum5 = IntObjInOff->Integral();
     IntObjInOff->Print();
     weighted_sum6 = IntObjOutOff->Integral();
@@ -171,8 +184,8 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
     std::cout << "*************************************" << std::endl << std::endl;
     // Chopper On Analysis
     onFile->cd();
-    onFile->GetObject("WaterIn",WaterInOn);
-    onFile->GetObject("NRFWaterIn",WaterNRFOn);
+    WaterInOn = GetHisto(onFile, "WaterIn");
+    WaterNRFOn = GetHisto(onFile, "NRFWaterIn");
     weighted_sum = WaterInOn->Integral();
     WaterInOn->Print();
     weighted_sum2 = WaterNRFOn->Integral();
@@ -180,8 +193,8 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
 
     // Chopper Off Analysis
     offFile->cd();
-    offFile->GetObject("WaterIn",WaterInOff);
-    offFile->GetObject("NRFWaterIn",WaterNRFOff);
+    WaterInOff = GetHisto(offFile, "WaterIn");
+    WaterNRFOff = GetHisto(offFile, "NRFWaterIn");
     weighted_sum3 = WaterInOff->Integral();
     WaterInOff->Print();
     weighted_sum4 = WaterNRFOff->Integral();
@@ -197,13 +210,13 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
     std::cout << "*************************************" << std::endl << std::endl;
     // Chopper On Analysis
     onFile->cd();
-    onFile->GetObject("Cherenkov_Weighted",CherenkovOn);
+    CherenkovOn = GetHisto(onFile, "Cherenkov_Weighted");
     weighted_sum = CherenkovOn->Integral();
     CherenkovOn->Print();
 
     // Chopper Off Analysis
     offFile->cd();
-    offFile->GetObject("Cherenkov_Weighted",CherenkovOff);
+    CherenkovOff = GetHisto(offFile, "Cherenkov_Weighted");
     weighted_sum2 = CherenkovOff->Integral();
     CherenkovOff->Print();
     double cher_z = abs(weighted_sum - weighted_sum2)/(sqrt(pow(sqrt(weighted_sum),2) + pow(sqrt(weighted_sum2),2)));
@@ -216,13 +229,13 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
     std::cout << "*************************************" << std::endl << std::endl;
     // Chopper On Analysis
     onFile->cd();
-    onFile->GetObject("Inc_Det_Weighted",DetData);
+    DetData = GetHisto(onFile, "Inc_Det_Weighted");
     weighted_sum = DetData->Integral();
     DetData->Print();
 
     // Chopper Off Analysis
     offFile->cd();
-    offFile->GetObject("Inc_Det_Weighted",DetDataOff);
+    DetDataOff = GetHisto(offFile, "Inc_Det_Weighted");
     weighted_sum2 = DetDataOff->Integral();
     DetDataOff->Print();
     double inc_det_z = abs(weighted_sum - weighted_sum2)/(sqrt(pow(sqrt(weighted_sum),2) + pow(sqrt(weighted_sum2),2)));
@@ -236,13 +249,13 @@ void PrintResults(const char* ChopOn, const char* ChopOff, std::string WeightOn
     std::cout << "*************************************" << std::endl << std::endl;
     // Chopper On Analysis
     onFile->cd();
-    onFile->GetObject("Detected_Weighted",DetOn);
+    DetOn = GetHisto(onFile, "Detected_Weighted");
     weighted_sum = DetOn->Integral();
     DetOn->Print();
 
     // Chopper Off Analysis
     offFile->cd();
-    offFile->GetObject("Detected_Weighted",DetOff);
+    DetOff = GetHisto(offFile, "Detected_Weighted");
     weighted_sum2 = DetOff->Integral();
     DetOff->Print();
     double det_z = abs(weighted_sum - weighted_sum2)/(sqrt(pow(sqrt(weighted_sum),2) + pow(sqrt(weighted_sum2),2)));
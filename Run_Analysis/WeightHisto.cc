@@ -3,6 +3,7 @@
 // ************************************************************************************************ //
 // To Run File:
 // root -b -q 'WeightHisto.cc("test", 2.1, true)'
+// root -b -q 'WeightHisto.cc("test", 2.1, true, 8)'   (fill with 8 threads)
 // ************************************************************************************************ //
 // ************************************************************************************************ //
 // File Explanation:
@@ -11,8 +12,16 @@
 // 1. InputFilename
 // 2. Max Energy of Bremsstrahlung Interrogation Object
 // 3. InputFile Chopper State 
+// Optional
+// 4. Number of threads (default 0, sequential)
 // 
-// This File Scans the Cherenkov Merged File and the EventCheck File. 
+// This File Scans the Cherenkov Merged File and the event correlation trees. The
+// correlation trees are taken from the input file when mantis ran with -e true,
+// otherwise from the test_NRF_to_Cher.root and test_NRF_to_Cher_to_Det.root files
+// written by EventCheck.cc.
+// Every tree is read once with RDataFrame, in chunks of entries, so the memory used
+// does not depend on the number of entries and all histograms of a tree are filled
+// in a single pass.
 // This file outputs all histograms that require weighting to 
 // a new root file with the Following Structure:
 // TFile**		test_WeightedHistogramOn.root	
@@ -24,241 +33,71 @@
 //  KEY: TH1D	wDet;1	Weighted Detector
 //
 
-bool WeightHisto(const char *InputFilenameBase, double Emax, bool chopState)
+// Returns the file holding the tree name: the input file or the side file, "" if neither has it
+std::string FindTree(const std::string &inFile, const std::string &sideFile, const char *name)
+{
+    TFile *f = TFile::Open(inFile.c_str());
+    bool found = f && f->GetKey(name);
+    if(f) f->Close();
+    if(found)
+      return inFile;
+    if(!gSystem->AccessPathName(sideFile.c_str()))
+      return sideFile;
+    return "";
+}
+
+bool WeightHisto(const char *InputFilenameBase, double Emax, bool chopState, int nThreads = 0)
 {
-    TFile *f1, *f2, *f3;
     time_t timer, timer2, time_start, time_end;
     time_start = std::time(&timer);
+    if(nThreads > 0)
+      ROOT::EnableImplicitMT(nThreads);
+
     std::string InFile = InputFilenameBase;
-    std::string InFileEvent, InFileEvent2, InFileCherMerged;
-    bool checkNRF_to_Cher, checkNRF_to_Cher_to_Det, checkCherenkov;
-    bool tcheck = false;
-    
-    if(chopState)
-    {
-      InFileEvent = InFile + "_NRF_to_CherOn.root";
-      InFileEvent2 = InFile + "_NRF_to_Cher_to_DetOn.root";
-      InFileCherMerged = InFile + "_CherenkovMergedOn.root";
-    }
-    else
-    {
-      InFileEvent = InFile + "_NRF_to_CherOff.root";
-      InFileEvent2 = InFile + "_NRF_to_Cher_to_DetOff.root";
-      InFileCherMerged = InFile + "_CherenkovMergedOff.root";
-    }
-    
+    std::string InFileCherMerged = InFile + (chopState ? "_CherenkovMergedOn.root" : "_CherenkovMergedOff.root");
+    std::string InFileEvent = FindTree(InFile + ".root", InFile + "_NRF_to_Cher.root", "nrf_to_cher_tree");
+    std::string InFileEvent2 = FindTree(InFile + ".root", InFile + "_NRF_to_Cher_to_Det.root", "nrf_to_cher_to_det_tree");
     InFile = InFile + ".root";
-    const char* InputFilename = InFile.c_str();
-    const char* InputFilenameEvent = InFileEvent.c_str();
-    const char* InputFilenameEvent2 = InFileEvent2.c_str();
-    const char* InputFilenameCher = InFileCherMerged.c_str();
+    bool checkNRF_to_Cher = (InFileEvent != "");
+    bool checkNRF_to_Cher_to_Det = (InFileEvent2 != "");
+    bool checkCherenkov = !gSystem->AccessPathName(InFileCherMerged.c_str());
+    if(!checkNRF_to_Cher)
+      std::cout << "NRF to Cherenkov Events not found. Skipping..." << std::endl;
+    if(!checkNRF_to_Cher_to_Det)
+      std::cout << "NRF to Cherenkov to Detected Events not found. Skipping..." << std::endl;
+    if(!checkCherenkov)
+      std::cout << " Merged Cherenkov File does not exist. Skipping..." << std::endl;
     
-    TFile *f = TFile::Open(InputFilename);
-    
-    if(gSystem->AccessPathName(InputFilenameEvent))
-    {
-        std::cout << "NRF to Cherenkov Event File does not exist. Skipping..." << std::endl;
-        checkNRF_to_Cher = false;
-    }
-    else
-    {
-        f1 = TFile::Open(InputFilenameEvent); 
-        checkNRF_to_Cher = true;
-    }
-    if(gSystem->AccessPathName(InputFilenameEvent2))
-    {
-        std::cout << "NRF to Cherenkov to Detected File does not exist. Skipping..." << std::endl;
-        checkNRF_to_Cher_to_Det = false;
-    }
-    else
-    {
-        f2 = TFile::Open(InputFilenameEvent2);  
-        checkNRF_to_Cher_to_Det = true;
-    }
-    if(gSystem->AccessPathName(InputFilenameCher))
-    {
-        std::cout << " Merged Cherenkov File does not exist. Skipping..." << std::endl;
-        checkCherenkov = false;
-    }
-    else
-    {
-        f3 = TFile::Open(InputFilenameCher);
-        checkCherenkov = true;
-    }
-    
-    TTree *ChopIn, *ChopOut, *NRFMatData, *DetInfo;
-    TTree *nrf_to_cher_tree, *nrf_to_cher_to_det_tree;
-    TH1D *Cherenkov;
     Int_t nbins = 100000;
+    ROOT::RDataFrame ChopIn("ChopIn", InFile);
+    ROOT::RDataFrame ChopOut("ChopOut", InFile);
+    ROOT::RDataFrame NRFMatData("NRFMatData", InFile);
+    ROOT::RDataFrame DetInfo("DetInfo", InFile);
     
-    TH1D *wChopIn = new TH1D("wChopIn","Weighted Chopper Incident",nbins,0.,Emax);
-    TH1D *wChopOut = new TH1D("wChopOut","Weighted Chopper Emission",nbins,0.,Emax);
-    TH1D *wNRF = new TH1D("wNRF","Weighted NRF",nbins,0.,Emax);
-    TH1D *wDet = new TH1D("wDet","Weighted Detector",nbins,0.,Emax);
-    TH1D *wNRF_NRF_to_Cher = new TH1D("wNRF_NRF_to_Cher","Weighted NRF Spectrum that Lead to Cherenkov",nbins, 0., Emax);
-    TH1D *wCher_NRF_to_Cher = new TH1D("wCher_NRF_to_Cher","Weighted Cherenkov Spectrum caused by NRF",nbins,0.,Emax);
-    TH1D *wNRF_NRF_to_Cher_to_Det = new TH1D("wNRF_NRF_to_Cher_to_Det","Weighted NRF Energy Spectrum that Lead to Cherenkov that Lead to Detection",nbins,0.,Emax);
-    TH1D *wCher_NRF_to_Cher_to_Det = new TH1D("wCher_NRF_to_Cher_to_Det","Weighted Cherenkov Energy Spectrum Caused by NRF that Lead to Detection", nbins, 0., Emax);
-    
-    // Grab file objects
-    f->cd();
-    f->GetObject("ChopIn",ChopIn);
-    f->GetObject("ChopOut",ChopOut);
-    f->GetObject("NRFMatData",NRFMatData);
-    f->GetObject("DetInfo",DetInfo);
-    
-    if(checkNRF_to_Cher)
-    {    
-      f1->cd();
-      f1->GetObject("nrf_to_cher_tree",nrf_to_cher_tree);
-      nrf_to_cher_tree->SetEstimate(-1);
-    }
-    if(checkNRF_to_Cher_to_Det)
-    {
-      f2->cd();
-      f2->GetObject("nrf_to_cher_to_det_tree",nrf_to_cher_to_det_tree);
-      nrf_to_cher_to_det_tree->SetEstimate(-1); 
-    }
-    if(checkCherenkov)
-    {
-      f3->cd();
-      f3->GetObject("wCher",Cherenkov);
-    }
-
-    ChopIn->SetEstimate(-1);
-    ChopOut->SetEstimate(-1);
-    NRFMatData->SetEstimate(-1);
-    DetInfo->SetEstimate(-1);
-
-    std::cout << "WeightHisto::Objects Grabbed!" << std::endl;
-    Int_t maxNumberOfEntries = 50000000;
-    std::cout << "WeightHisto::Setting Max Number of Entries to Draw: " << maxNumberOfEntries << std::endl;
-    // ******************************************************************************************************************************** //
-    // Variables Declared Objects Set up
-    // ******************************************************************************************************************************** //
-    
-    // ******************************************************************************************************************************** //
-    // Fill Chopper In Weighted Histogram
-    // ******************************************************************************************************************************** //
-    
-    if(ChopIn->GetEntries() > maxNumberOfEntries)
-    {
-        std::cerr << "WARNING: Chopper Incident Number of Entries Exceeds Max Number of Entries." << std::endl;
-        std::cerr << "Some data may not be transferred." << std::endl;
-    }
-    Int_t n = ChopIn->Draw("Energy:Weight","","goff",maxNumberOfEntries);
-    Double_t *energyIn = ChopIn->GetVal(0);
-    Double_t *weightIn = ChopIn->GetVal(1);
-    for(int i=0;i<n;i++)
-    {
-        wChopIn->Fill(energyIn[i],weightIn[i]);
-    }
-    std::cout << "Chopper Incident Filled." << std::endl;
-    // ******************************************************************************************************************************** //
-    // Fill Chopper Out Weighted Histogram
-    // ******************************************************************************************************************************** //
-    
-    if(ChopOut->GetEntries() > maxNumberOfEntries)
-    {
-        std::cerr << "WARNING: Chopper Emission Number of Entries Exceeds Max Number of Entries." << std::endl;
-        std::cerr << "Some data may not be transferred." << std::endl;
-    }
-    Int_t n1 = ChopOut->Draw("Energy:Weight","","goff",maxNumberOfEntries);
-    Double_t *energyOut = ChopOut->GetVal(0);
-    Double_t *weightOut = ChopOut->GetVal(1);
-    for(int i=0;i<n1;i++)
-    {
-        wChopOut->Fill(energyOut[i],weightOut[i]);
-    }
-    std::cout << "Chopper Emission Filled." << std::endl;
     // ******************************************************************************************************************************** //
-    // Fill NRF Weighted Histogram
+    // Book the Weighted Histograms, nothing is read until the first result is accessed
     // ******************************************************************************************************************************** //
     
-    if(NRFMatData->GetEntries() > maxNumberOfEntries)
-    {
-        std::cerr << "WARNING: NRF Number of Entries Exceeds Max Number of Entries." << std::endl;
-        std::cerr << "Some data may not be transferred." << std::endl;
-    }
-    Int_t n2 = NRFMatData->Draw("Energy:Weight","","goff", maxNumberOfEntries);
-    Double_t *nrfEnergy = NRFMatData->GetVal(0);
-    Double_t *nrfWeight = NRFMatData->GetVal(1);
-    for(int i=0;i<n2;i++)
-    {
-        wNRF->Fill(nrfEnergy[i],nrfWeight[i]);
-    }
-    std::cout << "NRF Filled." << std::endl;
-    
-    // ******************************************************************************************************************************** //
-    // Fill DetInfo Weighted Histogram
-    // ******************************************************************************************************************************** //
+    auto wChopIn = ChopIn.Histo1D({"wChopIn","Weighted Chopper Incident",nbins,0.,Emax}, "Energy", "Weight");
+    auto wChopOut = ChopOut.Histo1D({"wChopOut","Weighted Chopper Emission",nbins,0.,Emax}, "Energy", "Weight");
+    auto wNRF = NRFMatData.Histo1D({"wNRF","Weighted NRF",nbins,0.,Emax}, "Energy", "Weight");
+    auto wDet = DetInfo.Histo1D({"wDet","Weighted Detector",nbins,0.,Emax}, "Energy", "Weight");
     
-    if(DetInfo->GetEntries() > maxNumberOfEntries)
-    {
-        std::cout << "WARNING: Detector Information Number of Entries Exceeds Max Number of Entries." << std::endl;
-        std::cout << "Some data may not be transferred." << std::endl;
-    }
-    Int_t n4 = DetInfo->Draw("Energy:Weight","","goff", maxNumberOfEntries);
-    Double_t *detEnergy = DetInfo->GetVal(0);
-    Double_t *detWeight = DetInfo->GetVal(1);
-    for(int i=0;i<n4;i++)
-    {
-        wDet->Fill(detEnergy[i],detWeight[i]);
-    }
-    std::cout << "DetInfo Filled." << std::endl;
-    // ******************************************************************************************************************************** //
-    // Fill NRF that Lead to Cherenkov Weighted Histogram for NRF Energies and Cherenkov Energies
-    // ******************************************************************************************************************************** //
+    std::vector<ROOT::RDF::RResultPtr<TH1D> > correlations;
     if(checkNRF_to_Cher)
     {
-        if(nrf_to_cher_tree->GetEntries() > maxNumberOfEntries)
-        {
-            std::cout << "WARNING: NRF to Cherenkov Number of Entries Exceeds Max Number of Entries." << std::endl;
-            std::cout << "Some data may not be transferred." << std::endl;
-        }
-        Int_t n5 = nrf_to_cher_tree->Draw("NRF_Energy:NRF_Weight","","goff", maxNumberOfEntries);
-        Double_t *nrfcherNRFEnergy = nrf_to_cher_tree->GetVal(0);
-        Double_t *nrfcherNRFWeight = nrf_to_cher_tree->GetVal(1);
-        for(int i=0;i<n5;i++)
-        {
-            wNRF_NRF_to_Cher->Fill(nrfcherNRFEnergy[i], nrfcherNRFWeight[i]);
-        }
-
-        Int_t n6 = nrf_to_cher_tree->Draw("Cher_Energy:Cher_Weight","","goff",maxNumberOfEntries);
-        Double_t *nrfcherCherEnergy = nrf_to_cher_tree->GetVal(0);
-        Double_t *nrfcherCherWeight = nrf_to_cher_tree->GetVal(1);
-        for(int i=0;i<n6;i++)
-        {
-            wCher_NRF_to_Cher->Fill(nrfcherCherEnergy[i], nrfcherCherWeight[i]);
-        }
+        // NRF and Cherenkov spectra are filled in the same pass over the tree
+        ROOT::RDataFrame nrf_to_cher("nrf_to_cher_tree", InFileEvent);
+        correlations.push_back(nrf_to_cher.Histo1D({"wNRF_NRF_to_Cher","Weighted NRF Spectrum that Lead to Cherenkov",nbins, 0., Emax}, "NRF_Energy", "NRF_Weight"));
+        correlations.push_back(nrf_to_cher.Histo1D({"wCher_NRF_to_Cher","Weighted Cherenkov Spectrum caused by NRF",nbins,0.,Emax}, "Cher_Energy", "Cher_Weight"));
     }
-
-        // ******************************************************************************************************************************** //
-        // Fill NRF that Lead to Cherenkov that Lead to Detection Weighted Histogram for NRF Energies and Cherenkov Energies
-        // ******************************************************************************************************************************** //
     if(checkNRF_to_Cher_to_Det)
     {
-        if(nrf_to_cher_to_det_tree->GetEntries() > maxNumberOfEntries)
-        {
-            std::cout << "WARNING: NRF to Cherenkov to Detector Number of Entries Exceeds Max Number of Entries." << std::endl;
-            std::cout << "Some data may not be transferred." << std::endl;
-        }
-        Int_t n7 = nrf_to_cher_to_det_tree->Draw("EnergyNRF:WeightNRF","","goff",maxNumberOfEntries);
-        Double_t *nrfcherdetNRFEnergy = nrf_to_cher_to_det_tree->GetVal(0);
-        Double_t *nrfcherdetNRFWeight = nrf_to_cher_to_det_tree->GetVal(1);
-        for(int i=0;i<n7;i++)
-        {
-            wNRF_NRF_to_Cher_to_Det->Fill(nrfcherdetNRFEnergy[i], nrfcherdetNRFWeight[i]);
-        }
-
-        Int_t n8 = nrf_to_cher_to_det_tree->Draw("EnergyCher:WeightCher","","goff",maxNumberOfEntries);
-        Double_t *nrfcherdetCherEnergy = nrf_to_cher_to_det_tree->GetVal(0);
-        Double_t *nrfcherdetCherWeight = nrf_to_cher_to_det_tree->GetVal(1);
-        for(int i=0;i<n8;i++)
-        {
-            wCher_NRF_to_Cher_to_Det->Fill(nrfcherdetCherEnergy[i], nrfcherdetCherWeight[i]);
-        }
+        ROOT::RDataFrame nrf_to_cher_to_det("nrf_to_cher_to_det_tree", InFileEvent2);
+        correlations.push_back(nrf_to_cher_to_det.Histo1D({"wNRF_NRF_to_Cher_to_Det","Weighted NRF Energy Spectrum that Lead to Cherenkov that Lead to Detection",nbins,0.,Emax}, "EnergyNRF", "WeightNRF"));
+        correlations.push_back(nrf_to_cher_to_det.Histo1D({"wCher_NRF_to_Cher_to_Det","Weighted Cherenkov Energy Spectrum Caused by NRF that Lead to Detection", nbins, 0., Emax}, "EnergyCher", "WeightCher"));
     }
+    
     // ******************************************************************************************************************************** //
     // Write Weighted Histograms to File
     // ******************************************************************************************************************************** //
@@ -278,32 +117,29 @@ bool WeightHisto(const char *InputFilenameBase, double Emax, bool chopState)
     fout->cd();
     
     wChopIn->Write();
+    std::cout << "Chopper Incident Filled." << std::endl;
     wChopOut->Write();
+    std::cout << "Chopper Emission Filled." << std::endl;
     wNRF->Write();
+    std::cout << "NRF Filled." << std::endl;
     if(checkCherenkov)
     {
-      Cherenkov->Write();
+      TFile *f3 = TFile::Open(InFileCherMerged.c_str());
+      TH1D *Cherenkov = 0;
+      f3->GetObject("wCher",Cherenkov);
+      fout->cd();
+      if(Cherenkov)
+        Cherenkov->Write();
+      f3->Close();
     }
     wDet->Write();
+    std::cout << "DetInfo Filled." << std::endl;
     
-    if(checkNRF_to_Cher)
-    {
-        wNRF_NRF_to_Cher->Write();
-        wCher_NRF_to_Cher->Write();
-    }
-    
-    if(checkNRF_to_Cher_to_Det)
-    {
-        wNRF_NRF_to_Cher_to_Det->Write();
-        wCher_NRF_to_Cher_to_Det->Write();
-    }
+    for(unsigned int i=0; i<correlations.size(); ++i)
+      correlations[i]->Write();
     fout->Close();
     std::cout << "Weighted Histograms saved to: " << OutputFilename << std::endl; 
-    if(checkNRF_to_Cher && checkNRF_to_Cher_to_Det)
-    {
-        tcheck = true;
-    }
     time_end = std::time(&timer2);
     std::cout << "Weighting Histos took: " << std::difftime(time_end,time_start) << " seconds!" << std::endl;
-    return tcheck;
+    return checkNRF_to_Cher && checkNRF_to_Cher_to_Det;
 }
@@ -0,0 +1,415 @@
+//
+// ************************************************************************************************ //
+// ************************************************************************************************ //
+// To Run File:
+// mantis-analyze --on "testOn_*.root" --off "testOff_*.root" [-n threads=0] [-o summary=mantis_summary] [--paired]
+// ************************************************************************************************ //
+// ************************************************************************************************ //
+// File Explanation:
+//
+// Compiled replacement for PrintResults.cc
+// Requires 2 inputs
+// 1. Chopper On files (file names or quoted wildcard patterns, any number)
+// 2. Chopper Off files (file names or quoted wildcard patterns, any number)
+// Optional
+// 3. Number of threads (default 0 = all cores, 1 = sequential)
+// 4. Summary output prefix (default mantis_summary)
+// 5. --paired for runs made with /sampling/commonRandomNumbers true
+//
+// The per-seed files are read directly, there is no need to hadd them first.
+// The weighted histograms of every file are integrated in parallel and summed.
+// The event correlation trees (nrf_to_cher_tree and nrf_to_cher_to_det_tree, written
+// with -e true or by EventCheck) and DetInfo are streamed with RDataFrame across all
+// files that contain them.
+// This file prints to terminal all weighted sums and Z-Scores, and writes the same
+// numbers to <summary>.json and <summary>.csv
+//
+// With --paired the i-th On file and the i-th Off file must come from the same seed.
+// The tree quantities then also get a paired Z-Score: the variance of the On - Off
+// difference is estimated from the per event differences, which is much smaller than
+// the sum of the On and Off variances when the runs share their random numbers.
+//
+
+#include <glob.h>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TFile.h"
+#include "TH1D.h"
+#include "THnSparse.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "ROOT/RDataFrame.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+
+namespace
+{
+// Histograms written by mantis that are compared between chopper states
+const std::vector<std::pair<std::string, std::string> > histograms = {
+    {"ChopperIn_Weighted", "Chopper Incident"},
+    {"ChopperOut_Weighted", "Chopper Emission"},
+    {"IntObjIn", "Interrogation Object Incident"},
+    {"IntObjOut", "Interrogation Object Emission"},
+    {"NRFIntObjIn", "Interrogation Object NRF Incident"},
+    {"NRFIntObjOut", "Interrogation Object NRF Emission"},
+    {"WaterIn", "Water Tank Incident"},
+    {"NRFWaterIn", "Water Tank NRF incident"},
+    {"Cherenkov_Weighted", "Created Cherenkov Energy"},
+    {"Inc_Det_Weighted", "Incident Photocathode"},
+    {"Detected_Weighted", "Detected"}
+};
+
+// Tree columns that are summed directly: tree, weight column, description
+struct TreeSum
+{
+    std::string tree, column, description;
+};
+
+const std::vector<TreeSum> treeSums = {
+    {"DetInfo", "Weight", "Detected Events"},
+    {"nrf_to_cher_tree", "NRF_Weight", "NRF to Cherenkov NRF Spectrum"},
+    {"nrf_to_cher_tree", "Cher_Weight", "NRF to Cherenkov Cherenkov Spectrum"},
+    {"nrf_to_cher_to_det_tree", "WeightNRF", "NRF to Cherenkov to Detector NRF Spectrum"},
+    {"nrf_to_cher_to_det_tree", "WeightCher", "NRF to Cherenkov to Detector Cherenkov Spectrum"}
+};
+
+struct Result
+{
+    std::string name, description;
+    double on, off, on2, off2;
+    bool found;
+    double d2; // sum over events of the squared On - Off difference
+    bool paired;
+};
+
+void PrintUsage()
+{
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << "mantis-analyze --on <files...> --off <files...> [-n threads=0] [-o summary=mantis_summary] [--paired]" << std::endl;
+    exit(1);
+}
+
+// Expands a file name or wildcard pattern
+void AddFiles(const std::string &pattern, std::vector<std::string> &files)
+{
+    glob_t g;
+    if(glob(pattern.c_str(), 0, NULL, &g) == 0)
+    {
+        for(size_t i=0; i<g.gl_pathc; ++i)
+          files.push_back(g.gl_pathv[i]);
+    }
+    else
+    {
+        std::cerr << "WARNING: " << pattern << " matched no files." << std::endl;
+    }
+    globfree(&g);
+}
+
+// Integral, integral error squared and presence flag of every histogram in a file
+std::vector<double> HistoIntegrals(const std::string &fileName)
+{
+    std::vector<double> values(3*histograms.size(), 0.);
+    TFile *f = TFile::Open(fileName.c_str());
+    if(!f || f->IsZombie())
+    {
+        std::cerr << "WARNING: could not open " << fileName << std::endl;
+        return values;
+    }
+    for(unsigned int i=0; i<histograms.size(); ++i)
+    {
+        TObject *obj = f->Get(histograms[i].first.c_str());
+        if(!obj)
+          continue;
+        TH1 *h = 0;
+        // histograms written with /output/binning sparse are projected first
+        if(obj->InheritsFrom(THnSparse::Class()))
+          h = ((THnSparse*) obj)->Projection(0);
+        else if(obj->InheritsFrom(TH1::Class()))
+          h = (TH1*) obj;
+        if(!h)
+          continue;
+        double error = 0.;
+        values[3*i] = h->IntegralAndError(1, h->GetNbinsX(), error);
+        values[3*i+1] = error*error;
+        values[3*i+2] = 1.;
+        if(h != obj)
+          delete h;
+    }
+    f->Close();
+    delete f;
+    return values;
+}
+
+std::vector<double> SumIntegrals(const std::vector<std::vector<double> > &values)
+{
+    std::vector<double> sum(3*histograms.size(), 0.);
+    for(unsigned int i=0; i<values.size(); ++i)
+      for(unsigned int j=0; j<sum.size(); ++j)
+        sum[j] += values[i][j];
+    return sum;
+}
+
+// Files of the list that contain the tree
+std::vector<std::string> FilesWithTree(const std::vector<std::string> &files, const std::string &tree)
+{
+    std::vector<std::string> found;
+    for(unsigned int i=0; i<files.size(); ++i)
+    {
+        TFile *f = TFile::Open(files[i].c_str());
+        if(f && !f->IsZombie() && f->GetKey(tree.c_str()))
+          found.push_back(files[i]);
+        if(f)
+        {
+            f->Close();
+            delete f;
+        }
+    }
+    return found;
+}
+
+// Sum of weights and sum of weights squared of a column over all files
+void SumColumn(const std::string &tree, const std::string &column, const std::vector<std::string> &files,
+               double &sum, double &sum2)
+{
+    sum = sum2 = 0.;
+    if(files.empty())
+      return;
+    ROOT::RDataFrame df(tree, files);
+    auto w = df.Sum<double>(column);
+    auto w2 = df.Define("w2", [](double x) { return x*x; }, {column}).Sum<double>("w2");
+    sum = *w;
+    sum2 = *w2;
+}
+
+// Weight sum of every event of one file
+std::unordered_map<int, double> EventSums(const std::string &tree, const std::string &column, const std::string &file)
+{
+    std::unordered_map<int, double> sums;
+    ROOT::RDataFrame df(tree, file);
+    // both columns are taken in the same event loop so the entries line up
+    auto ids = df.Take<int>("EventID");
+    auto w = df.Take<double>(column);
+    for(size_t i=0; i<ids->size(); ++i)
+      sums[(*ids)[i]] += (*w)[i];
+    return sums;
+}
+
+// Sum over events of the squared On - Off difference, the files are paired by position
+double PairedVariance(const std::string &tree, const std::string &column,
+                      const std::vector<std::string> &onFiles, const std::vector<std::string> &offFiles)
+{
+    double d2 = 0.;
+    for(unsigned int k=0; k<onFiles.size(); ++k)
+    {
+        std::unordered_map<int, double> on = EventSums(tree, column, onFiles[k]);
+        std::unordered_map<int, double> off = EventSums(tree, column, offFiles[k]);
+        for(auto it = on.begin(); it != on.end(); ++it)
+        {
+            auto match = off.find(it->first);
+            double d = it->second - (match == off.end() ? 0. : match->second);
+            d2 += d*d;
+        }
+        for(auto it = off.begin(); it != off.end(); ++it)
+        {
+            if(on.find(it->first) == on.end())
+              d2 += it->second*it->second;
+        }
+    }
+    return d2;
+}
+
+// Same Z-score as PrintResults (Poisson on the weighted sums)
+double ZScore(double on, double off)
+{
+    if(on + off <= 0.)
+      return 0.;
+    return std::abs(on - off)/std::sqrt(on + off);
+}
+
+// Z-score of the On - Off difference with the paired variance
+double PairedZScore(const Result &r)
+{
+    if(!r.paired || r.d2 <= 0.)
+      return 0.;
+    return std::abs(r.on - r.off)/std::sqrt(r.d2);
+}
+
+// Z-score using the sum of the squared weights as the variance
+double WeightedZScore(const Result &r)
+{
+    if(r.on2 + r.off2 <= 0.)
+      return 0.;
+    return std::abs(r.on - r.off)/std::sqrt(r.on2 + r.off2);
+}
+
+void WriteSummary(const std::string &prefix, const std::vector<Result> &results,
+                  unsigned int nOn, unsigned int nOff)
+{
+    std::ofstream csv(prefix + ".csv");
+    csv << "name,description,on,off,sumw2_on,sumw2_off,z,z_weighted,z_paired" << std::endl;
+    csv.precision(10);
+    for(unsigned int i=0; i<results.size(); ++i)
+    {
+        const Result &r = results[i];
+        if(!r.found)
+          continue;
+        csv << r.name << ",\"" << r.description << "\"," << r.on << "," << r.off << "," << r.on2 << ","
+            << r.off2 << "," << ZScore(r.on, r.off) << "," << WeightedZScore(r) << ",";
+        if(r.paired)
+          csv << PairedZScore(r);
+        csv << std::endl;
+    }
+
+    std::ofstream json(prefix + ".json");
+    json.precision(10);
+    json << "{" << std::endl;
+    json << "  \"files_on\": " << nOn << "," << std::endl;
+    json << "  \"files_off\": " << nOff << "," << std::endl;
+    json << "  \"results\": [";
+    bool first = true;
+    for(unsigned int i=0; i<results.size(); ++i)
+    {
+        const Result &r = results[i];
+        if(!r.found)
+          continue;
+        json << (first ? "" : ",") << std::endl;
+        json << "    {\"name\": \"" << r.name << "\", \"description\": \"" << r.description
+             << "\", \"on\": " << r.on << ", \"off\": " << r.off << ", \"sumw2_on\": " << r.on2
+             << ", \"sumw2_off\": " << r.off2 << ", \"z\": " << ZScore(r.on, r.off)
+             << ", \"z_weighted\": " << WeightedZScore(r);
+        if(r.paired)
+          json << ", \"z_paired\": " << PairedZScore(r);
+        json << "}";
+        first = false;
+    }
+    json << std::endl << "  ]" << std::endl << "}" << std::endl;
+    std::cout << "Summary written to: " << prefix << ".json and " << prefix << ".csv" << std::endl;
+}
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> onFiles, offFiles;
+    std::vector<std::string> *current = 0;
+    int nThreads = 0;
+    std::string summary = "mantis_summary";
+    bool paired = false;
+
+    for(int i=1; i<argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--on")
+          current = &onFiles;
+        else if(arg == "--off")
+          current = &offFiles;
+        else if(arg == "-n" && i+1 < argc)
+          nThreads = atoi(argv[++i]);
+        else if(arg == "-o" && i+1 < argc)
+          summary = argv[++i];
+        else if(arg == "--paired")
+          paired = true;
+        else if(arg == "-h" || !current)
+          PrintUsage();
+        else
+          AddFiles(arg, *current);
+    }
+    if(onFiles.empty() || offFiles.empty())
+    {
+        std::cerr << "ERROR: both chopper On and Off files are required." << std::endl;
+        PrintUsage();
+    }
+    std::cout << "Chopper On Files: " << onFiles.size() << std::endl;
+    std::cout << "Chopper Off Files: " << offFiles.size() << std::endl;
+    if(paired && onFiles.size() != offFiles.size())
+    {
+        std::cerr << "ERROR: --paired needs one Off file for every On file." << std::endl;
+        exit(1);
+    }
+
+    time_t time_start = time(0);
+    if(nThreads != 1)
+      ROOT::EnableImplicitMT(nThreads);
+    else
+      ROOT::EnableThreadSafety();
+
+    // ******************************************************************************************************************************** //
+    // Weighted Histogram Integrals, one task per file
+    // ******************************************************************************************************************************** //
+
+    std::cout << std::endl << "Histogram Analysis..." << std::endl;
+    std::cout << "*************************************" << std::endl << std::endl;
+    ROOT::TThreadExecutor pool(nThreads > 0 ? nThreads : 0);
+    std::vector<double> on = pool.MapReduce(HistoIntegrals, onFiles, SumIntegrals);
+    std::vector<double> off = pool.MapReduce(HistoIntegrals, offFiles, SumIntegrals);
+
+    std::vector<Result> results;
+    for(unsigned int i=0; i<histograms.size(); ++i)
+    {
+        Result r = {histograms[i].first, histograms[i].second, on[3*i], off[3*i], on[3*i+1], off[3*i+1],
+                    on[3*i+2] > 0. && off[3*i+2] > 0., 0., false};
+        if(r.found && (on[3*i+2] != onFiles.size() || off[3*i+2] != offFiles.size()))
+          std::cerr << "WARNING: " << r.name << " is missing from some of the input files." << std::endl;
+        if(r.found)
+          std::cout << r.name << " On: " << r.on << " Off: " << r.off << std::endl;
+        results.push_back(r);
+    }
+
+    // ******************************************************************************************************************************** //
+    // Tree Analysis
+    // ******************************************************************************************************************************** //
+
+    std::cout << std::endl << "Tree Analysis..." << std::endl;
+    std::cout << "*************************************" << std::endl << std::endl;
+    for(unsigned int i=0; i<treeSums.size(); ++i)
+    {
+        const TreeSum &t = treeSums[i];
+        std::vector<std::string> onTree = FilesWithTree(onFiles, t.tree);
+        std::vector<std::string> offTree = FilesWithTree(offFiles, t.tree);
+        Result r = {t.tree + "." + t.column, t.description, 0., 0., 0., 0., !onTree.empty() && !offTree.empty(), 0., false};
+        if(!r.found)
+        {
+            std::cout << t.tree << " not found. Skipping..." << std::endl;
+            results.push_back(r);
+            continue;
+        }
+        SumColumn(t.tree, t.column, onTree, r.on, r.on2);
+        SumColumn(t.tree, t.column, offTree, r.off, r.off2);
+        if(paired && onTree.size() == offTree.size())
+        {
+            r.d2 = PairedVariance(t.tree, t.column, onTree, offTree);
+            r.paired = true;
+        }
+        else if(paired)
+          std::cerr << "WARNING: " << t.tree << " is missing from some of the files. No paired Z-Score." << std::endl;
+        std::cout << r.name << " On: " << r.on << " Off: " << r.off << std::endl;
+        results.push_back(r);
+    }
+
+    // ******************************************************************************************************************************** //
+    // Conduct Z Score Tests
+    // ******************************************************************************************************************************** //
+
+    std::cout << std::endl << "Z-Score Summary..." << std::endl;
+    std::cout << "*************************************" << std::endl << std::endl;
+    for(unsigned int i=0; i<results.size(); ++i)
+    {
+        if(!results[i].found)
+          continue;
+        std::cout << results[i].description << " Z-Score: " << ZScore(results[i].on, results[i].off)
+                  << " (sum of weights squared: " << WeightedZScore(results[i]) << ")";
+        if(results[i].paired)
+          std::cout << " Paired Z-Score: " << PairedZScore(results[i]);
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+
+    WriteSummary(summary, results, onFiles.size(), offFiles.size());
+    std::cout << "Analysis took: " << std::difftime(time(0), time_start) << " seconds!" << std::endl;
+    return 0;
+}
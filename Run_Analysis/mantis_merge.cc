@@ -0,0 +1,314 @@
+//
+// ************************************************************************************************ //
+// ************************************************************************************************ //
+// To Run File:
+// mantis-merge -p test -f 1 -l 101 [-o merged=test] [-j jobs=0] [-g group=8] [--skip-histograms] [--allow-missing]
+// ************************************************************************************************ //
+// ************************************************************************************************ //
+// File Explanation:
+//
+// Compiled replacement for stitch.sh + hadd
+// Requires 3 inputs
+// 1. Output prefix given to runBatch.sh (the per-seed files are prefix-<seed>.root)
+// 2. First seed
+// 3. Last seed (not included, same as runBatch.sh)
+// Optional
+// 4. Merged output prefix (default = prefix)
+// 5. Number of merge jobs run at the same time (default 0 = all cores)
+// 6. Number of files merged by each job (default 8)
+// 7. --skip-histograms only merges the trees
+// 8. --allow-missing merges whatever seeds are complete instead of stopping
+//
+// Every seed in the range is checked before anything is merged: the output must
+// exist, open cleanly (not recovered after a crash) and must not have a checkpoint
+// left over by an unfinished job.
+// The files are merged with a tree reduction: groups of files are merged in parallel
+// into temporary files which are merged again until one file is left. The side files
+// prefix-<seed>_NRF_to_Cher.root, prefix-<seed>_NRF_to_Cher_to_Det.root and
+// prefix-<seed>_WeightedHisto.root are merged in the same pass, and THnSparse
+// histograms (/output/binning sparse) are merged bin by bin without being densified.
+//
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TROOT.h"
+#include "TSystem.h"
+
+#include "HistoNames.hh"
+
+namespace
+{
+// Output files written by one mantis job, the main output has no suffix
+const std::vector<std::string> suffixes = {"", "_NRF_to_Cher", "_NRF_to_Cher_to_Det", "_WeightedHisto"};
+
+// Histograms written by mantis, dropped with --skip-histograms
+std::string HistogramNames()
+{
+    std::string names;
+    for(unsigned int i=0; i<HistoNames::kNumH1; ++i)
+        names += std::string(HistoNames::kH1[i]) + " ";
+    for(unsigned int i=0; i<HistoNames::kNumWeighted; ++i)
+        names += std::string(HistoNames::kWeighted[i]) + " ";
+    return names;
+}
+
+struct MergeJob
+{
+    std::vector<std::string> inputs;
+    std::string output;
+    bool ok;
+};
+
+void PrintUsage()
+{
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << "mantis-merge -p prefix -f first_seed -l last_seed [-o merged=prefix] [-j jobs=0] [-g group=8] "
+              << "[--skip-histograms] [--allow-missing]" << std::endl;
+    exit(1);
+}
+
+// True if the seed finished and its output can be merged
+bool CheckSeed(const std::string &prefix, long seed)
+{
+    std::string base = prefix + "-" + std::to_string(seed);
+    if(!gSystem->AccessPathName((base + ".checkpoint").c_str()))
+    {
+        std::cerr << "Seed " << seed << ": job did not finish (checkpoint found)." << std::endl;
+        return false;
+    }
+    if(gSystem->AccessPathName((base + ".root").c_str()))
+    {
+        std::cerr << "Seed " << seed << ": " << base << ".root not found." << std::endl;
+        return false;
+    }
+    TFile *f = TFile::Open((base + ".root").c_str());
+    bool ok = f && !f->IsZombie() && !f->TestBit(TFile::kRecovered);
+    if(!ok)
+      std::cerr << "Seed " << seed << ": " << base << ".root is corrupt or was not closed." << std::endl;
+    if(f)
+    {
+        f->Close();
+        delete f;
+    }
+    return ok;
+}
+
+bool Merge(MergeJob &job, bool skipHistograms)
+{
+    TFileMerger merger(kFALSE, kFALSE);
+    merger.SetPrintLevel(0);
+    if(!merger.OutputFile(job.output.c_str(), "RECREATE"))
+      return false;
+    for(unsigned int i=0; i<job.inputs.size(); ++i)
+    {
+        if(!merger.AddFile(job.inputs[i].c_str(), kFALSE))
+          return false;
+    }
+    // the random state of checkpointed parts only means something in its own file
+    merger.AddObjectNames("RandomState");
+    if(skipHistograms)
+      merger.AddObjectNames(HistogramNames().c_str());
+    return merger.PartialMerge(TFileMerger::kAll | TFileMerger::kRegular | TFileMerger::kSkipListed);
+}
+
+// Runs the jobs with at most nJobs at the same time
+void RunJobs(std::vector<MergeJob> &jobs, unsigned int nJobs, bool skipHistograms)
+{
+    std::atomic<unsigned int> next(0);
+    std::vector<std::thread> workers;
+    for(unsigned int t=0; t<nJobs && t<jobs.size(); ++t)
+    {
+        workers.push_back(std::thread([&]() {
+            for(unsigned int i=next++; i<jobs.size(); i=next++)
+              jobs[i].ok = Merge(jobs[i], skipHistograms);
+        }));
+    }
+    for(unsigned int t=0; t<workers.size(); ++t)
+      workers[t].join();
+}
+}
+
+int main(int argc, char **argv)
+{
+    std::string prefix, merged;
+    long first = -1, last = -1;
+    unsigned int nJobs = 0, group = 8;
+    bool skipHistograms = false, allowMissing = false;
+
+    for(int i=1; i<argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--skip-histograms")
+          skipHistograms = true;
+        else if(arg == "--allow-missing")
+          allowMissing = true;
+        else if(i+1 >= argc)
+          PrintUsage();
+        else if(arg == "-p")
+          prefix = argv[++i];
+        else if(arg == "-f")
+          first = atol(argv[++i]);
+        else if(arg == "-l")
+          last = atol(argv[++i]);
+        else if(arg == "-o")
+          merged = argv[++i];
+        else if(arg == "-j")
+          nJobs = atoi(argv[++i]);
+        else if(arg == "-g")
+          group = atoi(argv[++i]);
+        else
+          PrintUsage();
+    }
+    if(prefix == "" || first < 0 || last <= first || group < 2)
+      PrintUsage();
+    if(merged == "")
+      merged = prefix;
+    if(nJobs == 0)
+      nJobs = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+    time_t time_start = time(0);
+    ROOT::EnableThreadSafety();
+
+    // ******************************************************************************************************************************** //
+    // Completeness Check
+    // ******************************************************************************************************************************** //
+
+    std::vector<long> seeds;
+    unsigned int missing = 0;
+    for(long seed=first; seed<last; ++seed)
+    {
+        if(CheckSeed(prefix, seed))
+          seeds.push_back(seed);
+        else
+          ++missing;
+    }
+    std::cout << seeds.size() << " of " << last - first << " seeds complete." << std::endl;
+    if(missing > 0 && !allowMissing)
+    {
+        std::cerr << "ERROR: " << missing << " seeds are incomplete. Rerun them or use --allow-missing." << std::endl;
+        exit(1);
+    }
+    if(seeds.empty())
+    {
+        std::cerr << "ERROR: nothing to merge." << std::endl;
+        exit(1);
+    }
+
+    // current file list of every output, the side files are only merged if every seed has them
+    std::vector<std::vector<std::string> > lists(suffixes.size());
+    for(unsigned int s=0; s<suffixes.size(); ++s)
+    {
+        for(unsigned int i=0; i<seeds.size(); ++i)
+        {
+            std::string name = prefix + "-" + std::to_string(seeds[i]) + suffixes[s] + ".root";
+            if(!gSystem->AccessPathName(name.c_str()))
+              lists[s].push_back(name);
+        }
+        if(s > 0 && !lists[s].empty() && lists[s].size() != seeds.size())
+        {
+            std::cerr << "WARNING: " << suffixes[s] << " found for " << lists[s].size() << " of " << seeds.size()
+                      << " seeds. Skipping..." << std::endl;
+            lists[s].clear();
+        }
+    }
+
+    // ******************************************************************************************************************************** //
+    // Tree Reduction
+    // ******************************************************************************************************************************** //
+
+    std::vector<std::string> temporaries;
+    for(unsigned int level=0; ; ++level)
+    {
+        std::vector<MergeJob> jobs;
+        std::vector<std::pair<unsigned int, unsigned int> > owner; // suffix, position in the next list
+        std::vector<std::vector<std::string> > next(suffixes.size());
+        for(unsigned int s=0; s<suffixes.size(); ++s)
+        {
+            // a single file left is the final result of this output
+            if(lists[s].size() <= 1)
+            {
+                next[s] = lists[s];
+                continue;
+            }
+            unsigned int nGroups = (lists[s].size() + group - 1)/group;
+            for(unsigned int g=0; g<nGroups; ++g)
+            {
+                MergeJob job;
+                job.inputs.assign(lists[s].begin() + g*group,
+                                  lists[s].begin() + std::min<size_t>((g+1)*group, lists[s].size()));
+                job.output = merged + suffixes[s] + ".level" + std::to_string(level) + "_" + std::to_string(g) + ".root";
+                job.ok = false;
+                if(job.inputs.size() == 1)
+                {
+                    next[s].push_back(job.inputs[0]);
+                    continue;
+                }
+                next[s].push_back(job.output);
+                jobs.push_back(job);
+            }
+        }
+        if(jobs.empty())
+          break;
+
+        std::cout << "Level " << level << ": " << jobs.size() << " merge jobs" << std::endl;
+        RunJobs(jobs, nJobs, skipHistograms);
+        for(unsigned int i=0; i<jobs.size(); ++i)
+        {
+            if(!jobs[i].ok)
+            {
+                std::cerr << "ERROR: merging into " << jobs[i].output << " failed." << std::endl;
+                exit(1);
+            }
+            temporaries.push_back(jobs[i].output);
+        }
+        lists = next;
+    }
+
+    // ******************************************************************************************************************************** //
+    // Final Outputs
+    // ******************************************************************************************************************************** //
+
+    for(unsigned int s=0; s<suffixes.size(); ++s)
+    {
+        if(lists[s].empty())
+          continue;
+        std::string output = merged + suffixes[s] + ".root";
+        bool isTemporary = false;
+        for(unsigned int i=0; i<temporaries.size(); ++i)
+          isTemporary = isTemporary || temporaries[i] == lists[s][0];
+        // only one seed, nothing was merged so the input is copied
+        if(!isTemporary)
+        {
+            MergeJob job;
+            job.inputs = lists[s];
+            job.output = output;
+            if(!Merge(job, skipHistograms))
+            {
+                std::cerr << "ERROR: copying " << lists[s][0] << " failed." << std::endl;
+                exit(1);
+            }
+        }
+        else if(std::rename(lists[s][0].c_str(), output.c_str()) != 0)
+        {
+            std::cerr << "ERROR: could not rename " << lists[s][0] << " to " << output << std::endl;
+            exit(1);
+        }
+        std::cout << "Merged " << seeds.size() << " files into " << output << std::endl;
+    }
+    for(unsigned int i=0; i<temporaries.size(); ++i)
+      unlink(temporaries[i].c_str());
+
+    std::cout << "Merging took: " << std::difftime(time(0), time_start) << " seconds!" << std::endl;
+    return 0;
+}
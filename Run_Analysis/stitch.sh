@@ -1,4 +1,6 @@
 #!/bin/bash
+# For mantis batch outputs prefer mantis-merge, which checks the seed range and
+# merges the files (and the _NRF_to_Cher, _NRF_to_Cher_to_Det, _WeightedHisto side files) in parallel
 filepattern=$1 #this needs to be a pattern with wildcards etc.  on the command line it goes into "" quotes
 fileout=$2 #the final file
 
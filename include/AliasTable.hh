@@ -0,0 +1,63 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AliasTable_h
+#define AliasTable_h 1
+
+#include "globals.hh"
+#include "Randomize.hh"
+#include "TH1D.h"
+#include <vector>
+
+// Walker alias table of a binned energy distribution. A draw picks a bin in constant
+// time from one random number and places the energy uniformly inside the bin, the same
+// as TH1::GetRandom without the binary search over the cumulative integral.
+// With a target distribution every bin also stores the importance sampling weight
+// target/pdf so the draw returns the energy and its weight together.
+
+class AliasTable
+{
+public:
+AliasTable(const TH1D* pdf, const TH1D* target = NULL);
+~AliasTable();
+
+// Draw an energy in the units of the histogram axis, weight is target/pdf of its bin (1 without target)
+G4double Sample(G4double& weight) const;
+
+G4int GetNumberOfBins() const
+{
+  return (G4int) prob.size();
+}
+
+private:
+std::vector<G4double> prob;     // probability of keeping the drawn bin
+std::vector<G4int> alias;       // bin taken otherwise
+std::vector<G4double> edges;    // bin edges, size = bins + 1
+std::vector<G4double> binWeight;
+// target histogram with a different binning than pdf, its weight is looked up per draw
+const TH1D* fTarget;
+const TH1D* fPdf;
+};
+
+#endif
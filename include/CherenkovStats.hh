@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef CherenkovStats_h
+#define CherenkovStats_h 1
+
+#include "globals.hh"
+
+// Running summary of the Cherenkov producing steps of one event in constant memory:
+// the max energy with its weight, count, sum and sum of squares of the energies and
+// times and the earliest time.
+
+class CherenkovStats
+{
+public:
+CherenkovStats();
+~CherenkovStats();
+
+void Reset();
+void AddEnergy(G4double energy, G4double weight);
+void AddTime(G4double time);
+
+G4int GetCount() const
+{
+  return nEnergy;
+}
+G4double GetMaxEnergy() const
+{
+  return maxEnergy;
+}
+G4double GetMaxWeight() const
+{
+  return maxWeight;
+}
+G4double GetMeanEnergy() const;
+G4double GetEnergyRMS() const;
+G4double GetMeanTime() const;
+G4double GetTimeRMS() const;
+G4double GetTimeMin() const
+{
+  return nTime > 0 ? timeMin : 0.;
+}
+
+private:
+G4int nEnergy, nTime;
+G4double maxEnergy, maxWeight, sumEnergy, sumEnergy2;
+G4double sumTime, sumTime2, timeMin;
+};
+
+#endif
@@ -59,6 +59,7 @@
 #include "G4RunManager.hh"
 #include "G4NistManager.hh"
 #include "G4RotationMatrix.hh"
+#include "NRFBiasingOperator.hh"
 
 
 class G4VPhysicalVolume;
@@ -76,6 +77,10 @@ virtual ~DetectorConstruction();
 
 
 virtual G4VPhysicalVolume* Construct();
+// Attaches the forced NRF biasing (-b) to the interrogation object and/or the chopper
+virtual void ConstructSDandField();
+// Rebuild the chopper material from the current chopper settings between runs
+void UpdateChopperMaterial();
 
 void SetAttenuatorState(G4bool val)
 {
@@ -243,6 +248,8 @@ G4double getEndIntObj()const
 {
         return EndIntObj;
 }
+// Water tank settings an optical response map depends on
+G4String GetOpticalSignature() const;
 void SetPC_material(G4String val)
 {
         pc_mat = val;
@@ -251,6 +258,10 @@ void SetnPMT(G4int val)
 {
         nPMT = val;
 }
+G4int GetnPMT()const
+{
+        return nPMT;
+}
 void SetChopperOn(G4bool val)
 {
         chopperOn = val;
@@ -295,9 +306,17 @@ void SetCheckOverlaps(G4bool val)
 {
   checkOverlaps = val;
 }
+void SetNRFForcing(G4double val)
+{
+  nrfForcing = val;
+  if(fNRFBias)
+    fNRFBias->SetForcing(val);
+}
 
 private:
 
+G4Material* BuildChopperMaterial();
+
 // Brem Properties 
 G4double linac_size = 9*cm;
 
@@ -307,6 +326,7 @@ G4bool chopperOn;
 G4double chopper_U235_abundance, chopper_U238_abundance, chopper_Pu239_abundance, chopper_Pu240_abundance;
 G4double BeginChopper;
 G4double EndChop;
+G4int nChopperBuilds;
 
 // Interrogation Object Properties 
 G4double EndIntObj, IntObj_rad, intObjDensity, intObj_x_pos, intObj_y_pos, intObj_z_pos;
@@ -327,6 +347,7 @@ G4LogicalVolume* logicPC;
 G4LogicalVolume* logicPMT;
 G4VPhysicalVolume* physPC;
 G4LogicalVolume* logicChopper;
+G4LogicalVolume* logicIntObj;
 G4VPhysicalVolume* physWater;
 G4VPhysicalVolume* physTape;
 
@@ -354,6 +375,10 @@ G4bool DetectorViewOnly, material_verbose, checkOverlaps;
 // Messenger 
 DetectorMessenger* detectorM;
 
+// NRF Biasing
+NRFBiasingOperator* fNRFBias;
+G4double nrfForcing;
+
 };
 
 
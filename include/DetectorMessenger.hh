@@ -47,6 +47,7 @@ public:
 
   void SetNewValue(G4UIcommand*, G4String); // must always be a string input
 private:
+  void UpdateChopper();
   DetectorConstruction* DetectorA;
   G4UIcmdWithADouble* Cmd;
   G4UIcmdWithADouble* CmdX;
@@ -58,6 +59,7 @@ private:
   G4UIcmdWithADouble* CmdtZpos;
   G4UIcmdWithADouble* Cmdtrad;
   G4UIcmdWithAString* Cmdtsel;
+  G4UIcmdWithADouble* CmdNRFForcing;
   G4UIcmdWithAString* Cmdpcmat;
   G4UIcmdWithAnInteger* CmdnPMT;
   G4UIcmdWithAString* CmdChopMaterial;
@@ -66,6 +68,8 @@ private:
   G4UIcmdWithAString* CmdChopperOn;
   G4UIcmdWithADouble* CmdChopperAbundance;
   G4UIcmdWithADouble* CmdAngle;
+  G4UIcmdWithAnInteger* CmdNRFSplit;
+  G4UIcmdWithADouble* CmdNRFSplitWindow;
   G4UIcmdWithAString* CmdAttenOn;
   G4bool check_atten_on = false;
   G4UIcmdWithADouble* CmdAttenThick;
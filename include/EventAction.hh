@@ -37,22 +37,23 @@
 #include "G4UImanager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Run.hh"
+#include "CherenkovStats.hh"
 
 class G4Event;
 
 class EventAction : public G4UserEventAction
 {
 public:
-EventAction();
+EventAction(HistoManager*);
 ~EventAction();
 
 public:
 void BeginOfEventAction(const G4Event*);
 void EndOfEventAction(const G4Event*);
 
-void CherenkovEnergy(G4double energy)
+void CherenkovEnergy(G4double energy, G4double weight)
 {
-  energyv.push_back(energy);
+  cherStats.AddEnergy(energy, weight);
 }
 void CherenkovSecondaries(G4int secondaries)
 {
@@ -60,23 +61,45 @@ void CherenkovSecondaries(G4int secondaries)
 }
 void CherenkovTime(G4double times)
 {
-  timev.push_back(times);
+  cherStats.AddTime(times);
 }
-
-private:
-
-G4double calcAvg()
+const CherenkovStats& GetCherenkovStats() const
+{
+  return cherStats;
+}
+// keep the first NRF of the event
+void NRFEvent(G4double energy, G4double weight, G4double time)
+{
+  if(nrfFlag)
+    return;
+  nrfFlag = true;
+  nrfEnergy = energy;
+  nrfWeight = weight;
+  nrfTime = time;
+}
+// keep the first detected optical photon of the event
+void DetectedEvent(G4double time)
 {
-  for(std::size_t i=0;i<timev.size();++i)
-  {
-    sum += timev.at(i);
-  }
-  return sum/timev.size();
+  if(!detFlag || time < detTime)
+    detTime = time;
+  detFlag = true;
 }
+G4bool HasDetection() const
+{
+  return detFlag;
+}
+G4double GetDetectionTime() const
+{
+  return detTime;
+}
+
+private:
 
+HistoManager* fHistoManager;
 G4int c_secondaries;
-G4double sum;
-std::vector<double> energyv, timev;
+CherenkovStats cherStats;
+G4bool nrfFlag, detFlag;
+G4double nrfEnergy, nrfWeight, nrfTime, detTime;
 };
 
 #endif
@@ -29,50 +29,131 @@
 #include "G4Types.hh"
 #include "G4ios.hh"
 #include <vector>
+#include <memory>
+#include <map>
+#include <utility>
+#include "OutputCodes.hh"
 
 #include "TROOT.h"
-#include "TApplication.h"
 #include "TSystem.h"
-#include "TH1.h"
-#include "TPad.h"
-#include "TCanvas.h"
 #include "TFile.h"
 #include "TTree.h"
 #include "TBranch.h"
-#include "TMath.h"
 #include "TString.h"
+#include "TKey.h"
+#include "TChain.h"
+#include <string>
+#include <algorithm>
+
+#ifdef MANTIS_RNTUPLE
+#include "RNTupleOutput.hh"
+#if __has_include(<ROOT/RNTupleReader.hxx>)
+#include <ROOT/RNTupleReader.hxx>
+#endif
+#endif
 
-class TH1D;
 class TFile;
 class TTree;
-class TBranch;
 
+// One row of the NRFMatData, Cherenkov or DetInfo datasets
+struct EventRow
+{
+  G4int rank;
+  G4int eventID;
+  G4double energy;
+  G4double weight;
+  G4double time;
+};
+
+// The EventIDs restart with every run, so the key of an event is the position of its run
+// (Seed column) in the run order of the file and the EventID. hadd keeps the runs of a
+// merged file in the same order in every dataset.
+typedef std::pair<G4int, G4int> EventKey;
+
+// Reads one dataset of one mantis output file entry by entry in file order, grouping
+// the rows of each event. Only the rows of the current event are kept in memory
+// and the TTree cache reads the needed branches one cluster at a time.
+
+class EventStream
+{
+public:
+EventStream(TFile* f, const char* name, const char* timeColumn,
+            const char* selColumn = "", const std::vector<G4int>& selCodes = std::vector<G4int>());
+~EventStream();
+
+// Append the runs of the dataset in file order, false if a run is not contiguous
+G4bool ScanRuns(std::vector<G4int>& runs);
+// Start reading with the position of every run in the file
+void Start(const std::map<G4int, G4int>& runRank);
+// Read all rows of the next event into group, false once the dataset is exhausted
+G4bool NextEvent(std::vector<EventRow>& group);
+
+G4bool Done() const
+{
+  return fDone;
+}
+EventKey GetKey() const
+{
+  return EventKey(fHead.rank, fHead.eventID);
+}
+// true once a decreasing key was read, e.g. a merged file written before the Seed column
+G4bool IsUnordered() const
+{
+  return fUnordered;
+}
+G4long GetRowsRead() const
+{
+  return fRowsRead;
+}
+
+private:
+// read the next selected row into fHead
+void Advance();
+
+G4bool fDone, fUnordered;
+G4long fRowsRead;
+EventRow fHead;
+std::vector<G4int> fSelCodes;
+Long64_t fEntry, fEntries;
+const std::map<G4int, G4int>* fRunRank;
+
+TTree* fTree;
+G4int bEventID, bCode, bSeed;
+G4double bEnergy, bWeight, bTime;
+G4bool hasTime, hasSeed;
+
+#ifdef MANTIS_RNTUPLE
+std::unique_ptr<RNT::RNTupleReader> fReader;
+std::unique_ptr<RNT::RNTupleView<G4int> > fEventIDView, fCodeView, fSeedView;
+std::unique_ptr<RNT::RNTupleView<G4double> > fEnergyView, fWeightView, fTimeView;
+#endif
+};
+
+// Joins the NRF, Cherenkov and DetInfo datasets of mantis output files on the event key
+// with a streaming sort-merge join and writes the nrf_to_cher_tree and
+// nrf_to_cher_to_det_tree side files. Each input file is joined on its own, the file
+// name may contain wildcards to join the output files of several runs. The rows of one event in one dataset are
+// combined with the aggregation: first (first row), max (row with the max energy)
+// or sum (first row with the summed weight).
 
 class EventCheck
 {
 public:
-    EventCheck();
+    EventCheck(const G4String& fileName, const G4String& aggregation = "first");
     ~EventCheck();
     
 public:
-    void WriteEvents();
+    // false if an input cannot be joined, then no output is written
+    G4bool WriteEvents();
     
 private:
+EventRow Aggregate(const std::vector<EventRow>& group) const;
+// Order the runs consistently with the run order of every dataset, false if the orders contradict
+G4bool OrderRuns(const std::vector<std::vector<G4int> >& runs, std::map<G4int, G4int>& runRank) const;
 
 time_t timer, timer2, time_start, time_end;
-TFile *f, *fout, *fout2;
-TTree *Cherenkov, *NRF, *DetData, *nrf_to_cher_tree, *nrf_to_cher_to_det_tree;
-std::vector<int> cherEventv, nrfEventv, detEventv, nrf_to_cherEvents, cher_to_detEvents, nrf_to_detEvents;
-std::vector<double> cher_to_detEnergies, cher_to_detWeights, cher_to_detTimes;
-std::vector<double> nrf_to_detEnergies, nrf_to_detWeights, nrf_to_detTimes;
-std::vector<double> nrfEnergyv, nrfWeightv, cherEnergyv, cherWeightv;
-std::vector<double> nrf_to_cherenkov_to_detEvents, nrf_to_cherenkov_to_detNRFEnergies, nrf_to_cherenkov_to_detCherEnergies;
-std::vector<double> nrf_to_cherenkov_to_detNRFWeights, nrf_to_cherenkov_to_detCherWeights;
-std::vector<double> nrf_to_cherenkov_to_detNRFTimes, nrf_to_cherenkov_to_detCherTimes;
-double nrfE,nrfW, cherE, cherW, a, energyNRF, energyCher, weightNRF, weightCher, timeNRF, timeCher;
-int nrf_cher_EventID;
-G4int num_entries, num_entries1, num_entries2, x, index;
-
+std::vector<G4String> inputNames;
+G4String baseName, agg;
 };
 
 #endif
@@ -95,6 +95,13 @@ class G4NRF : public G4VDiscreteProcess {
 
   void print_to_standalone(ofstream& file);
 
+  // Splitting of the emitted gammas: every gamma is sampled nSplit times with weight 1/nSplit,
+  // copies outside the cones of halfWidth around the two water tanks at angle (from the beam
+  // axis) are kept with probability 1/nSplit at the full weight
+  static void SetSplitting(G4int n) {nSplit = n;}
+  static void SetSplittingAngle(G4double angle) {splitAngle = angle;}
+  static void SetSplittingWindow(G4double halfWidth) {splitHalfWidth = halfWidth;}
+
  private:
   G4NRF & operator=(const G4NRF &right);
   G4NRF(const G4NRF&);
@@ -124,8 +131,15 @@ class G4NRF : public G4VDiscreteProcess {
           const G4int L1, const G4int L2,
           const G4double Delta1, const G4double Delta2);
 
+  // samples the correlation of the last ReInit
+  G4ThreeVector SampleCorrelatedDirection();
+
   G4ThreeVector SampleIsotropic();
 
+  G4bool InSplittingWindow(const G4ThreeVector& direction) const;
+
+  void AddGamma(const G4Track& trackData, const G4ThreeVector& direction, G4double E_gamma, G4double weight);
+
   G4int FindMin_L(const G4double Ji, const G4double Pi,
     const G4double Jf, const G4double Pf, char& transition);
 
@@ -155,6 +169,10 @@ class G4NRF : public G4VDiscreteProcess {
   G4double param_x;
   G4double param_t;
 
+  static G4int nSplit;
+  static G4double splitAngle;
+  static G4double splitHalfWidth;
+
   // numerical integration
   G4Integrator<const G4NRF, G4double(G4NRF::*)(G4double) const> integrator;
 };
@@ -29,12 +29,31 @@
 #include "g4root.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+#include "OutputCodes.hh"
 
 #include "TFile.h"
 #include "TROOT.h"
 #include "TH1D.h"
+#include "THnSparse.h"
 #include "TSystem.h"
+#include "TKey.h"
+#include "TFileMerger.h"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "OutputQueue.hh"
 
+#ifdef MANTIS_RNTUPLE
+#include "RNTupleOutput.hh"
+#endif
+
+class HistoMessenger;
 
 class HistoManager
 {
@@ -44,16 +63,144 @@ HistoManager();
 
 void finish();     // close root file
 void Book();
+// Count the finished event and write a checkpoint when one is due
+void EndOfEvent(G4int eventID);
+// Change the output file name between runs, used to write several runs from one job
+void SetOutputName(G4String name);
+
+// Fill the energy histogram ID, dispatches to the sparse histograms when selected
+// With the asynchronous writer all fills are queued and written by the I/O thread
+void FillH1(G4int id, G4double x, G4double w=1.);
+
+// Fill one row of the output datasets with the selected backend
+void FillChopIn(G4int eventID, G4double energy, G4double weight);
+void FillChopOut(G4int eventID, G4double energy, G4double weight, G4int isNRF);
+void FillNRF(G4int eventID, G4double energy, G4double weight, G4int material, G4double zPos, G4double time);
+void FillCherenkov(G4int eventID, G4double energy, G4double weight, G4int secondaries, G4double time, G4double timeMin, G4double timeRMS);
+void FillDet(G4int eventID, G4double energy, G4double weight, G4int creatorProcess, G4double time);
+void FillIncDet(G4int eventID, G4double energy, G4double weight, G4int detProcess);
+// Event correlations: NRF events that lead to optical photons (and to a detection)
+void FillNRFToCher(G4int eventID, G4double nrfEnergy, G4double nrfWeight, G4double cherEnergy, G4double cherWeight);
+void FillNRFToCherToDet(G4int eventID, G4double nrfEnergy, G4double nrfWeight, G4double cherEnergy, G4double cherWeight,
+                        G4double nrfTime, G4double detTime);
 
 G4double GetEmax()const
 {
   return xmax;
 }
+G4int GetEventOffset()const
+{
+  return fEventOffset;
+}
+G4bool IsComplete()const
+{
+  return fComplete;
+}
+G4int GetAnalysisThreads()const
+{
+  return analysisThreads;
+}
+void SetAnalysisThreads(G4int val)
+{
+  analysisThreads = val;
+}
+const std::vector<G4double>& GetBinEdges()const
+{
+  return edges;
+}
+void SetBinning(G4String val)
+{
+  binning = val;
+}
+void SetBinWidth(G4double val)
+{
+  binWidth = val;
+}
+void SetFineBinWidth(G4double val)
+{
+  fineBinWidth = val;
+}
+void SetResonanceWindow(G4double val)
+{
+  resonanceWindow = val;
+}
+void SetFormat(G4String val)
+{
+  format = val;
+}
+void SetCompression(G4String val)
+{
+  compression = val;
+}
+void SetCompressionLevel(G4int val)
+{
+  compressionLevel = val;
+}
+void SetClusterSize(G4double val)
+{
+  clusterSize = val;
+}
+void SetAsync(G4bool val)
+{
+  async = val;
+}
+void SetQueueSize(G4int val)
+{
+  queueSize = val;
+}
+void SetCheckpointEvents(G4int val)
+{
+  checkpointEvents = val;
+}
+void SetCheckpointSeconds(G4double val)
+{
+  checkpointSeconds = val;
+}
 
 private:
+void Dispatch(const OutputRecord&);
+void WriteRecord(const OutputRecord&);
+void StartWriter();
+void StopWriter();
+void WriterLoop();
+G4String PartName(G4int part) const;
+void Checkpoint();
+void WritePart();
+void WriteCheckpoint();
+void ReadCheckpoint();
+void MergeParts();
+void CreateNtuples();
+G4int GetCompressionSettings() const;
+void BuildEdges();
+void CreateH1(const G4String& name, const G4String& title, G4double xmin, G4double xmax_in, const G4String& unit);
+
 G4bool fFactoryOn;
 G4double xmax;
 TH1D *hBrems;
+G4String binning;
+G4double binWidth, fineBinWidth, resonanceWindow;
+std::vector<G4double> edges, resonances;
+std::vector<THnSparseD*> sparseHistos;
+G4String format, compression;
+G4int compressionLevel;
+G4double clusterSize; // MB
+G4bool useRNTuple;
+G4bool async;
+G4int queueSize;
+OutputQueue* fQueue;
+std::thread fWriter;
+std::atomic<G4bool> fWriterRunning;
+G4AnalysisManager* fManager;
+G4int checkpointEvents;
+G4int analysisThreads;
+G4double checkpointSeconds;
+G4bool useParts, fComplete;
+G4int fPart, fEventsDone, fEventsAtCheckpoint, fTotalEvents, fEventOffset;
+time_t fLastCheckpoint;
+HistoMessenger* histoM;
+#ifdef MANTIS_RNTUPLE
+RNTupleOutput* fRNTuple;
+#endif
 };
 
 #endif
@@ -0,0 +1,65 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef HistoMessenger_h
+#define HistoMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "HistoManager.hh"
+#include "globals.hh"
+
+class HistoManager;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+
+class HistoMessenger: public G4UImessenger
+{
+public:
+  HistoMessenger(HistoManager*);
+  ~HistoMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+private:
+  HistoManager* histoM;
+  G4UIcmdWithAString* CmdBinning;
+  G4UIcmdWithADouble* CmdBinWidth;
+  G4UIcmdWithADouble* CmdFineBinWidth;
+  G4UIcmdWithADouble* CmdWindow;
+  G4UIcmdWithAString* CmdFormat;
+  G4UIcmdWithAString* CmdCompression;
+  G4UIcmdWithAnInteger* CmdCompressionLevel;
+  G4UIcmdWithADouble* CmdClusterSize;
+  G4UIcmdWithABool* CmdAsync;
+  G4UIcmdWithAnInteger* CmdQueueSize;
+  G4UIcmdWithAnInteger* CmdCheckpointEvents;
+  G4UIcmdWithADouble* CmdCheckpointSeconds;
+  G4UIcmdWithAnInteger* CmdAnalysisThreads;
+  G4UIcmdWithAString* CmdFileName;
+};
+
+#endif
@@ -0,0 +1,46 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef HistoNames_h
+#define HistoNames_h 1
+
+// Names of the histograms written by mantis. HistoManager and WeightHisto create
+// the histograms under these names and mantis-merge drops them with --skip-histograms.
+namespace HistoNames
+{
+// HistoManager H1 ids 0 - 11
+const char* const kH1[] = {
+  "ChopperIn_Weighted", "ChopperOut_Weighted", "IntObjIn", "NRFIntObjIn", "IntObjOut", "NRFIntObjOut",
+  "WaterIn", "NRFWaterIn", "NRF_Weighted", "Cherenkov_Weighted", "Inc_Det_Weighted", "Detected_Weighted"
+};
+const unsigned int kNumH1 = sizeof(kH1)/sizeof(kH1[0]);
+
+// WeightHisto, written to the _WeightedHisto file
+const char* const kWeighted[] = {
+  "wNRF_NRF_to_Cher", "wCher_NRF_to_Cher", "wNRF_to_Det", "wCher_to_Det"
+};
+const unsigned int kNumWeighted = sizeof(kWeighted)/sizeof(kWeighted[0]);
+}
+
+#endif
@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef NRFBiasingOperator_h
+#define NRFBiasingOperator_h 1
+
+#include "globals.hh"
+#include "G4VBiasingOperator.hh"
+#include "G4BOptnChangeCrossSection.hh"
+#include "G4BiasingProcessInterface.hh"
+#include <map>
+
+// Forced NRF interaction in the volumes it is attached to. While a gamma is on a resonance
+// the NRF cross section is raised so that forcing interaction lengths fit into the distance
+// left to the surface of the volume, i.e. the gamma undergoes NRF in the volume with a
+// probability of about 1 - exp(-forcing). The biasing framework multiplies the track weight
+// by the analog over the biased interaction probability, which the secondaries inherit.
+// Off resonance (no NRF cross section) the gamma is transported analog.
+
+class NRFBiasingOperator : public G4VBiasingOperator
+{
+public:
+NRFBiasingOperator(G4String name = "ForceNRF");
+virtual ~NRFBiasingOperator();
+
+virtual void StartRun();
+
+void SetForcing(G4double val)
+{
+  forcing = val;
+}
+
+private:
+virtual G4VBiasingOperation* ProposeOccurenceBiasingOperation(const G4Track*, const G4BiasingProcessInterface*);
+virtual G4VBiasingOperation* ProposeFinalStateBiasingOperation(const G4Track*, const G4BiasingProcessInterface*)
+{
+  return 0;
+}
+virtual G4VBiasingOperation* ProposeNonPhysicsBiasingOperation(const G4Track*, const G4BiasingProcessInterface*)
+{
+  return 0;
+}
+
+G4double forcing;
+std::map<const G4BiasingProcessInterface*, G4BOptnChangeCrossSection*> fChangeCrossSection;
+};
+
+#endif
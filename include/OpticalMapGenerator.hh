@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OpticalMapGenerator_h
+#define OpticalMapGenerator_h 1
+
+#include "G4VUserPrimaryGeneratorAction.hh"
+#include "globals.hh"
+#include "G4ParticleGun.hh"
+#include "G4Event.hh"
+#include "G4Navigator.hh"
+#include "G4AffineTransform.hh"
+#include "G4LogicalVolume.hh"
+#include "DetectorConstruction.hh"
+#include <vector>
+
+class OpticalMapMessenger;
+
+// Primary generator of the optical map mode (mantis -d true). Every event is one optical photon
+// started in the Water volume of the first tank, the photons walk through the grid of positions,
+// directions and energies with nPhotons per bin. OpticalMapSteppingAction reports the photocathode
+// detections back, /optical/map/generate runs the grid split over worker processes and writes the
+// OpticalResponseMap file.
+
+class OpticalMapGenerator : public G4VUserPrimaryGeneratorAction
+{
+public:
+OpticalMapGenerator(const DetectorConstruction*);
+virtual ~OpticalMapGenerator();
+
+virtual void GeneratePrimaries(G4Event*);
+
+void SetBins(G4int x, G4int y, G4int z)
+{
+  nx = x;
+  ny = y;
+  nz = z;
+}
+void SetDirectionBins(G4int c, G4int p)
+{
+  nCos = c;
+  nPhi = p;
+}
+void SetEnergyBins(G4int n, G4double lo, G4double hi)
+{
+  nE = n;
+  Emin = lo;
+  Emax = hi;
+}
+void SetPhotonsPerBin(G4int val)
+{
+  nPhotons = val;
+}
+void SetWorkers(G4int val)
+{
+  nWorkers = val;
+}
+
+// Photon of the current event detected by PMT copy number pmt at time
+void Detected(G4int pmt, G4double time);
+
+// Runs the grid and writes the map, an existing map of the same tank and binning is kept
+void Generate(const G4String& fileName);
+
+private:
+G4int GetNumberOfBins() const
+{
+  return nx*ny*nz*nCos*nPhi*nE;
+}
+// Transform of the first Water placement below mother, false if there is none
+G4bool FindWater(G4LogicalVolume* mother, const G4AffineTransform& toGlobal);
+// Runs bins [first, last) in this process and writes the sums to partName
+G4bool RunWorker(G4int first, G4int last, const G4String& partName);
+
+const DetectorConstruction* local_det;
+OpticalMapMessenger* mapM;
+G4ParticleGun* fParticleGun;
+G4Navigator* fNavigator;
+G4AffineTransform waterToGlobal;
+G4double halfX, halfY, halfZ;
+
+G4int nx, ny, nz, nCos, nPhi, nE, nPhotons, nWorkers, nPMT;
+G4double Emin, Emax;
+G4int firstBin, currentBin;
+// per bin of the worker and PMT: detections, sum of the times and of the squared times
+std::vector<G4double> counts, sumTime, sumTime2;
+};
+
+#endif
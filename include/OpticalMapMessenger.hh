@@ -0,0 +1,58 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OpticalMapMessenger_h
+#define OpticalMapMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+#include "OpticalMapGenerator.hh"
+
+class OpticalMapGenerator;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIdirectory;
+
+class OpticalMapMessenger: public G4UImessenger
+{
+public:
+  OpticalMapMessenger(OpticalMapGenerator*);
+  ~OpticalMapMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+private:
+  OpticalMapGenerator* mapG;
+  G4UIcmdWithAString* CmdBins;
+  G4UIcmdWithAString* CmdDirectionBins;
+  G4UIcmdWithAString* CmdEnergyBins;
+  G4UIcmdWithAnInteger* CmdPhotons;
+  G4UIcmdWithAnInteger* CmdWorkers;
+  G4UIcmdWithAString* CmdGenerate;
+  G4UIdirectory *myDir;
+};
+
+#endif
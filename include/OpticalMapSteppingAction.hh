@@ -0,0 +1,47 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OpticalMapSteppingAction_h
+#define OpticalMapSteppingAction_h 1
+
+#include "G4UserSteppingAction.hh"
+#include "globals.hh"
+#include "G4Step.hh"
+#include "OpticalMapGenerator.hh"
+
+// Stepping action of the optical map mode, reports the photocathode detections to the generator
+
+class OpticalMapSteppingAction : public G4UserSteppingAction
+{
+public:
+OpticalMapSteppingAction(OpticalMapGenerator*);
+virtual ~OpticalMapSteppingAction();
+
+virtual void UserSteppingAction(const G4Step*);
+
+private:
+OpticalMapGenerator* kgenerator;
+};
+
+#endif
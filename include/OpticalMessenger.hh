@@ -0,0 +1,62 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OpticalMessenger_h
+#define OpticalMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIdirectory.hh"
+#include "StackingAction.hh"
+
+class StackingAction;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIdirectory;
+
+class OpticalMessenger: public G4UImessenger
+{
+public:
+  OpticalMessenger(StackingAction*);
+  ~OpticalMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+private:
+  StackingAction* stackA;
+  G4UIcmdWithAString* CmdFastMap;
+  G4UIcmdWithAnInteger* CmdThinning;
+  G4UIcmdWithABool* CmdPreSampleQE;
+  G4UIcmdWithAnInteger* CmdMaxPE;
+  G4UIcmdWithAnInteger* CmdMaxTracks;
+  G4UIcmdWithADouble* CmdTimeGate;
+  G4UIdirectory *myDir;
+};
+
+#endif
@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OpticalResponseMap_h
+#define OpticalResponseMap_h 1
+
+#include "globals.hh"
+#include "Randomize.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+
+// Detection probability and arrival time of an optical photon in the water tank, binned in
+// the emission position and direction (in the coordinates of the Water volume) and the photon
+// energy. With a map loaded the StackingAction samples the response of every Cherenkov and
+// Scintillation photon instead of tracking it to the photocathodes.
+//
+// ROOT file layout (written by /optical/map/generate, see OpticalMapGenerator):
+// OpticalMapBinning     TVectorD {nx, ny, nz, nCos, nPhi, nE, Emin [eV], Emax [eV], nPMT, halfX, halfY, halfZ [mm]}
+// OpticalMapProbability TVectorF detection probability per bin and PMT
+// OpticalMapTimeMean    TVectorF mean delay from emission to detection per bin and PMT [ns]
+// OpticalMapTimeRMS     TVectorF rms of the delay per bin and PMT [ns]
+// OpticalMapGeometry    TNamed   DetectorConstruction::GetOpticalSignature() of the tank it was made for
+
+class OpticalResponseMap
+{
+public:
+OpticalResponseMap();
+~OpticalResponseMap();
+
+// Reads a map, false if the file or one of the objects is missing
+G4bool Load(const G4String& fileName);
+
+// Bin of an emission, -1 outside the map
+G4int GetBin(const G4ThreeVector& localPos, const G4ThreeVector& localDir, G4double energy) const;
+
+// PMT (0 to nPMT-1) that detects the photon or -1, delay is its arrival time after emission
+G4int Sample(const G4ThreeVector& localPos, const G4ThreeVector& localDir, G4double energy, G4double& delay) const;
+
+const G4String& GetSignature() const
+{
+  return signature;
+}
+G4int GetNumberOfPMTs() const
+{
+  return nPMT;
+}
+G4int GetNumberOfBins() const
+{
+  return nx*ny*nz*nCos*nPhi*nE;
+}
+
+protected:
+G4int nx, ny, nz, nCos, nPhi, nE, nPMT;
+G4double Emin, Emax, halfX, halfY, halfZ;
+std::vector<float> probability, timeMean, timeRMS;
+G4String signature;
+};
+
+#endif
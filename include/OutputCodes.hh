@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OutputCodes_h
+#define OutputCodes_h 1
+
+#include "globals.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessTable.hh"
+#include "G4OpBoundaryProcess.hh"
+#include <map>
+
+#include "TFile.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+
+// Integer codes written to the NRFMatData Material, DetInfo CreatorProcess
+// and IncDetInfo DetProcess columns. The code -> name dictionaries are stored
+// in the output file as TObjArrays of TObjString where the array index is the code.
+
+// Photocathode boundary status codes (IncDetInfo DetProcess)
+enum DetProcessCode
+{
+  kTrans = 0, kRefr, kIntRefl, kLamb, kLobe, kSpike, kBackS, kAbs, kDet,
+  kNotAtBoundary, kSameMaterial, kStepTooSmall, kNoRINDEX, kNoStatus, kNumDetProcessCodes
+};
+
+class OutputCodes
+{
+public:
+// Index of the physical volume in the G4PhysicalVolumeStore
+static G4int GetVolumeCode(const G4VPhysicalVolume*);
+// 0 for primaries ("Brem") otherwise 1 + index in the G4ProcessTable name list
+static G4int GetProcessCode(const G4VProcess*);
+static G4int GetDetProcessCode(G4OpBoundaryProcessStatus);
+
+// Write the MaterialCodes, CreatorProcessCodes and DetProcessCodes dictionaries
+static void Write(TFile*);
+// Returns the code of name in dictionary dictName stored in the file, -1 if not found
+static G4int LookUp(TFile*, const char* dictName, const char* name);
+
+private:
+static std::map<const G4VPhysicalVolume*, G4int> volumeCodes;
+static std::map<const G4VProcess*, G4int> processCodes;
+};
+
+#endif
@@ -0,0 +1,81 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OutputQueue_h
+#define OutputQueue_h 1
+
+#include "globals.hh"
+#include <vector>
+#include <atomic>
+
+// Compact record of one ntuple row or histogram fill handed to the output writer thread
+enum OutputRecordType
+{
+  kChopInRecord = 0, kChopOutRecord, kNRFRecord, kCherenkovRecord, kDetRecord, kIncDetRecord, kH1Record,
+  kNRFToCherRecord, kNRFToCherToDetRecord
+};
+
+struct OutputRecord
+{
+  G4int type;
+  G4int id;       // event ID, or histogram ID for kH1Record
+  G4int code;     // isNRF, material, secondaries, creator process or detection process
+  G4double energy;
+  G4double weight;
+  G4double extra; // z position or time
+  // second energy, weight and time of the event correlation records,
+  // time rms (energy2) and min time (time2) of the Cherenkov records, NRF time (time2) of the NRF records
+  G4double energy2;
+  G4double weight2;
+  G4double time2;
+};
+
+// Bounded lock-free single producer / single consumer ring buffer. The run manager
+// is sequential so the tracking thread is the only producer and the writer thread
+// the only consumer. Push blocks while the queue is full which bounds the memory
+// used and applies backpressure to the tracking thread.
+
+class OutputQueue
+{
+public:
+OutputQueue(std::size_t capacity);
+~OutputQueue();
+
+void Push(const OutputRecord&);
+G4bool Pop(OutputRecord&);
+
+G4long GetNumberOfStalls() const
+{
+  return fStalls;
+}
+
+private:
+std::vector<OutputRecord> fBuffer;
+std::size_t fMask;
+std::atomic<std::size_t> fHead; // next record to pop, written by the consumer
+std::atomic<std::size_t> fTail; // next free slot, written by the producer
+G4long fStalls;
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include "G4PhysicalConstants.hh"
 #include "G4DecayPhysics.hh"
 #include "G4NRFPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
 
 #include "G4OpticalPhysics.hh"
 #ifdef G4_OPTPARAM
@@ -64,7 +65,7 @@
 
 class PhysicsListNew: public G4VModularPhysicsList {
  public:
-  PhysicsListNew(G4bool, G4bool, G4bool, G4bool, G4bool, G4bool);
+  PhysicsListNew(G4bool, G4bool, G4bool, G4bool, G4bool, G4bool, G4bool);
   ~PhysicsListNew();
 
   void ConstructParticle();
@@ -73,7 +74,7 @@ class PhysicsListNew: public G4VModularPhysicsList {
   void SetCuts();
 
  private:
-  G4bool addNRF, use_xsec_tables, use_xsec_integration, force_isotropic, standalone, NRF_Verbose;
+  G4bool addNRF, use_xsec_tables, use_xsec_integration, force_isotropic, standalone, NRF_Verbose, biasNRF;
 };
 
 #endif
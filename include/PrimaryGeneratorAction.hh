@@ -36,21 +36,23 @@
 #include "G4Gamma.hh"
 #include "G4Electron.hh"
 #include "eventInformation.hh"
+#include "AliasTable.hh"
+#include "ResonanceSource.hh"
 
 #include "TFile.h"
 #include "TROOT.h"
 #include "TH1D.h"
-#include "TRandom1.h"
 #include "TSystem.h"
 
 class G4Event;
 class HistoManager;
+class PrimaryGeneratorMessenger;
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
 
 public:
-PrimaryGeneratorAction();
+PrimaryGeneratorAction(HistoManager*);
 virtual ~PrimaryGeneratorAction();
 
 public:
@@ -62,14 +64,36 @@ G4ParticleGun* GetParticleGun()
 
 G4double SampleUResonances();
 
+void SetCommonRandomNumbers(G4bool val)
+{
+  commonRandomNumbers = val;
+}
+void SetReplayEvent(G4int val)
+{
+  replayEvent = val;
+}
+// Resonance targeted sampling of hBrems, see ResonanceSource
+void AddResonanceIsotope(G4int Z, G4int A);
+void SetContinuumFraction(G4double val);
+void SetResonanceWindow(G4double val);
+
 private:
+// Seed every random engine from the run seed and the event ID
+void SeedEvent(G4int eventID);
+
+G4bool commonRandomNumbers;
+G4int replayEvent;
+PrimaryGeneratorMessenger* genM;
 G4double beamStart = 129.9;
 G4bool file_check;
 G4ParticleGun* fParticleGun;
+HistoManager* fHistoManager;
 
-TRandom1 Random;
 TH1D *hBrems;
 TH1D *hSample;
+// energy and weight of the input spectrum in one draw
+AliasTable *fSampleTable;
+ResonanceSource *fResonanceSource;
 
 protected:
 G4float energy;
@@ -0,0 +1,61 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef PrimaryGeneratorMessenger_h
+#define PrimaryGeneratorMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIdirectory.hh"
+#include "PrimaryGeneratorAction.hh"
+
+class PrimaryGeneratorAction;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAString;
+class G4UIdirectory;
+
+class PrimaryGeneratorMessenger: public G4UImessenger
+{
+public:
+  PrimaryGeneratorMessenger(PrimaryGeneratorAction*);
+  ~PrimaryGeneratorMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+private:
+  PrimaryGeneratorAction* genA;
+  G4UIcmdWithABool* CmdCRN;
+  G4UIcmdWithAnInteger* CmdReplay;
+  G4UIcmdWithAString* CmdResIsotope;
+  G4UIcmdWithADouble* CmdContinuum;
+  G4UIcmdWithADouble* CmdResWindow;
+  G4UIdirectory *myDir;
+};
+
+#endif
@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RNTupleOutput_h
+#define RNTupleOutput_h 1
+
+// Only built when CMake finds ROOT >= 6.30 with RNTuple support
+#ifdef MANTIS_RNTUPLE
+
+#include "globals.hh"
+#include <memory>
+
+#include "TFile.h"
+#include "RVersion.h"
+#include <ROOT/RNTupleModel.hxx>
+#if __has_include(<ROOT/RNTupleWriter.hxx>)
+#include <ROOT/RNTupleWriter.hxx>
+#include <ROOT/RNTupleWriteOptions.hxx>
+#else
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleOptions.hxx>
+#endif
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,35,0)
+namespace RNT = ROOT;
+#else
+namespace RNT = ROOT::Experimental;
+#endif
+
+// Writes the ChopIn, ChopOut, NRFMatData, Cherenkov, DetInfo and IncDetInfo
+// datasets, and with event checking the nrf_to_cher_tree and nrf_to_cher_to_det_tree
+// datasets, as RNTuples with the same column names and types as the TTree output.
+
+class RNTupleOutput
+{
+public:
+RNTupleOutput(const G4String& fileName, G4int compressionSettings, G4double clusterSizeMB);
+~RNTupleOutput();
+
+void FillChopIn(G4int eventID, G4double energy, G4double weight);
+void FillChopOut(G4int eventID, G4double energy, G4double weight, G4int isNRF);
+void FillNRF(G4int eventID, G4double energy, G4double weight, G4int material, G4double zPos, G4double time);
+void FillCherenkov(G4int eventID, G4double energy, G4double weight, G4int secondaries, G4double time, G4double timeMin, G4double timeRMS);
+void FillDet(G4int eventID, G4double energy, G4double weight, G4int creatorProcess, G4double time);
+void FillIncDet(G4int eventID, G4double energy, G4double weight, G4int detProcess);
+void FillNRFToCher(G4int eventID, G4double nrfE, G4double nrfW, G4double cherE, G4double cherW);
+void FillNRFToCherToDet(G4int eventID, G4double nrfE, G4double nrfW, G4double cherE, G4double cherW, G4double nrfTime, G4double detTime);
+
+private:
+std::unique_ptr<RNT::RNTupleWriter> MakeWriter(std::unique_ptr<RNT::RNTupleModel> model, const char* name);
+
+TFile* fFile;
+RNT::RNTupleWriteOptions fOptions;
+
+std::unique_ptr<RNT::RNTupleWriter> chopInWriter, chopOutWriter, nrfWriter, cherWriter, detWriter, incDetWriter;
+std::unique_ptr<RNT::RNTupleWriter> nrfToCherWriter, nrfToCherToDetWriter;
+
+std::shared_ptr<G4double> chopInEnergy, chopInWeight;
+std::shared_ptr<G4int> chopInEventID;
+std::shared_ptr<G4double> chopOutEnergy, chopOutWeight;
+std::shared_ptr<G4int> chopOutEventID, chopOutIsNRF;
+std::shared_ptr<G4int> nrfEventID, nrfMaterial, nrfSeed;
+std::shared_ptr<G4double> nrfEnergy, nrfWeight, nrfZPos, nrfTime;
+std::shared_ptr<G4double> cherEnergy, cherWeight, cherTime, cherTimeMin, cherTimeRMS;
+std::shared_ptr<G4int> cherEventID, cherSecondaries, cherSeed;
+std::shared_ptr<G4int> detEventID, detCreatorProcess, detSeed;
+std::shared_ptr<G4double> detEnergy, detWeight, detTime;
+std::shared_ptr<G4int> incDetEventID, incDetProcess;
+std::shared_ptr<G4double> incDetEnergy, incDetWeight;
+std::shared_ptr<G4int> nrfToCherEventID;
+std::shared_ptr<G4double> nrfToCherNRFEnergy, nrfToCherNRFWeight, nrfToCherCherEnergy, nrfToCherCherWeight;
+std::shared_ptr<G4int> toDetEventID;
+std::shared_ptr<G4double> toDetNRFEnergy, toDetCherEnergy, toDetNRFWeight, toDetCherWeight, toDetNRFTime, toDetCherTime;
+};
+
+#endif // MANTIS_RNTUPLE
+#endif
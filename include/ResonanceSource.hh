@@ -0,0 +1,83 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ResonanceSource_h
+#define ResonanceSource_h 1
+
+#include "globals.hh"
+#include "Randomize.hh"
+#include "AliasTable.hh"
+#include "TH1D.h"
+#include <vector>
+
+// Resonance targeted primary spectrum. The NRF levels of the selected isotopes are read
+// from the loaded G4NRF level database and every level is sampled in a window of a few
+// Doppler widths around its resonance energy. A fraction of the draws is taken from the
+// bremsstrahlung spectrum itself so the continuum stays covered. The weight of a draw
+// is the exact ratio of the bremsstrahlung density to the density of this mixture.
+
+class ResonanceSource
+{
+public:
+ResonanceSource(const TH1D* brems);
+~ResonanceSource();
+
+void AddIsotope(G4int Z, G4int A);
+void SetContinuumFraction(G4double val)
+{
+  continuumFraction = val;
+}
+void SetWindow(G4double val)
+{
+  window = val;
+}
+
+// Draw an energy in MeV, weight is the bremsstrahlung density over the sampling density
+G4double Sample(G4double& weight);
+
+private:
+// Reads the levels once the NRF level data can be loaded
+void Initialize();
+// Normalised bremsstrahlung density per MeV
+G4double BremsDensity(G4double e) const;
+// Normalised density of the resonance windows per MeV
+G4double WindowDensity(G4double e) const;
+
+const TH1D* fBrems;
+AliasTable *fContinuum;
+G4double bremsTotal;
+G4double continuumFraction;
+G4double window;      // half width of a window in Doppler widths
+G4bool initialized;
+
+std::vector<G4int> isoZ, isoA;
+// one entry per level, energies in MeV
+std::vector<G4double> lineEnergy;
+std::vector<G4double> lineDelta;     // Doppler width
+std::vector<G4double> lineCumulative;
+std::vector<G4double> lineProb;
+G4double windowNorm;                 // erf(window)
+};
+
+#endif
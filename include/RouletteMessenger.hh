@@ -0,0 +1,55 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RouletteMessenger_h
+#define RouletteMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIdirectory.hh"
+#include "RouletteRules.hh"
+
+class RouletteRules;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+class G4UIdirectory;
+
+class RouletteMessenger: public G4UImessenger
+{
+public:
+  RouletteMessenger(RouletteRules*);
+  ~RouletteMessenger();
+
+  void SetNewValue(G4UIcommand*, G4String);
+private:
+  RouletteRules* rouletteR;
+  G4UIcmdWithAString* CmdRule;
+  G4UIcmdWithAString* CmdWindow;
+  G4UIcmdWithoutParameter* CmdClear;
+  G4UIdirectory *myDir;
+};
+
+#endif
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef RouletteRules_h
+#define RouletteRules_h 1
+
+#include "globals.hh"
+#include "Randomize.hh"
+#include "G4Track.hh"
+#include <vector>
+
+class RouletteMessenger;
+
+// Russian roulette of low importance tracks, e.g. gammas scattered below the lowest NRF line
+// in the container. A rule matches a particle below an energy in the volumes whose name starts
+// with a prefix. A matching track survives with probability survival and its weight is divided
+// by survival, which the outputs pick up through the track weight (see eventInformation).
+// A weight window keeps the weight of matching tracks between wLow and wHigh: lighter tracks
+// are rouletted up to the window centre, heavier tracks are split into copies of equal weight.
+// The rules and the roulette of the windows are applied to new tracks in StackingAction and to
+// tracks entering a volume in SteppingAction, the splitting only to tracks entering a volume.
+
+class RouletteRules
+{
+public:
+RouletteRules();
+~RouletteRules();
+
+void AddRule(G4String volume, G4double Emax, G4double survival, G4String particle);
+void AddWindow(G4String volume, G4double Emax, G4double wLow, G4double wHigh, G4String particle);
+void Clear();
+void Print() const;
+
+G4bool HasRules() const
+{
+  return !rules.empty() || !windows.empty();
+}
+
+// Rolls the roulette for a track in volumeName, true if the track is killed. Survivors get the new weight.
+G4bool Apply(G4Track* track, const G4String& volumeName) const;
+// Number of equal weight copies a track entering volumeName is split into, 1 if it is not split.
+G4int Split(const G4Track* track, const G4String& volumeName) const;
+
+private:
+struct Rule
+{
+  G4String volume;
+  G4String particle;
+  G4double Emax;
+  G4double survival;
+};
+struct Window
+{
+  G4String volume;
+  G4String particle;
+  G4double Emax;
+  G4double wLow;
+  G4double wHigh;
+};
+const Window* FindWindow(const G4Track* track, const G4String& volumeName) const;
+std::vector<Rule> rules;
+std::vector<Window> windows;
+RouletteMessenger* rouletteM;
+};
+
+#endif
@@ -33,7 +33,6 @@
 #include "G4RunManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
-#include "EventCheck.hh"
 #include "WeightHisto.hh"
 
 class RunAction : public G4UserRunAction
@@ -54,11 +53,14 @@ class RunAction : public G4UserRunAction
     void AddTotalSurface(void) {fTotalSurface += 1;}
     void AddNRF(void){fNRF++;}
     void AddStatusKilled(void){fStatusKilled++;}
+    void AddEarlyAbort(G4double weight){fEarlyAbort++; fEarlyAbortWeight += weight;}
+    void AddOpticalCut(void){fOpticalCut++;}
 
   private:
     HistoManager* fHistoManager;
     G4double fCerenkovEnergy, fScintEnergy, fCerenkovCount;
-    G4int fScintCount, fTotalSurface, fNRF, fStatusKilled;
+    G4int fScintCount, fTotalSurface, fNRF, fStatusKilled, fEarlyAbort, fOpticalCut;
+    G4double fEarlyAbortWeight;
 };
 
 
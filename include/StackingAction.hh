@@ -37,18 +37,99 @@
 #include "DetectorConstruction.hh"
 #include "G4Neutron.hh"
 #include "RunAction.hh"
+#include "RouletteRules.hh"
+#include "OpticalResponseMap.hh"
+#include "HistoManager.hh"
+#include "EventAction.hh"
+#include "G4MaterialPropertyVector.hh"
+#include "G4VTouchable.hh"
+#include <vector>
+
+class OpticalMessenger;
+class StackingMessenger;
 
 class StackingAction : public G4UserStackingAction
 {
 public:
-StackingAction(const DetectorConstruction*, RunAction*);
+StackingAction(const DetectorConstruction*, RunAction*, EventAction*, HistoManager*, RouletteRules*);
 virtual ~StackingAction();
 
 public:
 virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack);
+virtual void PrepareNewEvent();
+virtual void NewStage();
+
+// Loads the fast optical response map, "none" goes back to tracking the optical photons
+G4bool SetOpticalMap(G4String fileName);
+
+// Keep 1 in val optical photons at val times their weight
+void SetOpticalThinning(G4int val)
+{
+  opticalThinning = val;
+}
+// Sample the photocathode quantum efficiency when the optical photon is created
+void SetQEPreSampling(G4bool val)
+{
+  qePreSampling = val;
+}
+// Staged stacking: tracks reaching a water tank wait until the rest of the event is done and the event
+// ends there if none of them has at least val, 0 turns it off
+void SetEarlyAbortEnergy(G4double val)
+{
+  earlyAbortEnergy = val;
+}
+// Track the optical photons in a stage of their own after everything else
+void SetDeferOptical(G4bool val)
+{
+  deferOptical = val;
+}
+// Per event caps of the optical photons, 0 turns a cap off
+void SetMaxPE(G4int val)
+{
+  maxPE = val;
+}
+void SetMaxOpticalTracks(G4int val)
+{
+  maxOpticalTracks = val;
+}
+void SetTimeGate(G4double val)
+{
+  timeGate = val;
+}
+// Counts a photoelectron of PMT copy pmt, false once the PMT has maxPE of them this event
+G4bool AcceptDetection(const G4VTouchable* touchable, G4int pmt);
+
+// True while SteppingAction has to suspend the tracks entering a water tank
+G4bool SuspendAtTanks() const
+{
+  return earlyAbortEnergy > 0. && stage == 0;
+}
+
 private:
+// Fills the detector outputs for a photon the map detected, as SteppingAction does at the photocathode
+void FillDetected(const G4Track* aTrack, G4double time);
+// EFFICIENCY of the photocathode surface, NULL before /run/initialize
+G4MaterialPropertyVector* FindQE() const;
+// Index of a PMT over both tanks, the PMT copy numbers 1 to nPMT repeat in every tank
+G4int GetPMTIndex(const G4VTouchable* touchable, G4int pmt) const;
+
   const DetectorConstruction* local_det;
   RunAction* local_run;
+  RouletteRules* local_roulette;
+  EventAction* local_event;
+  HistoManager* local_histo;
+  OpticalResponseMap* fOpticalMap;
+  G4int opticalThinning;
+  G4bool qePreSampling;
+  G4MaterialPropertyVector* fQE;
+  OpticalMessenger* opticalM;
+  StackingMessenger* stackM;
+  G4double earlyAbortEnergy;
+  G4bool deferOptical, tankReached;
+  G4int stage;
+  G4int maxPE, maxOpticalTracks, nOpticalTracks, nSaturated;
+  G4double timeGate;
+  std::vector<G4int> peCount;
 };
 
 #endif
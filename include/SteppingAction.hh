@@ -33,10 +33,13 @@
 #include "RunAction.hh"
 #include "StackingAction.hh"
 #include "HistoManager.hh"
+#include "OutputCodes.hh"
 #include "StepMessenger.hh"
 #include "EventAction.hh"
 #include "DetectorConstruction.hh"
 #include "eventInformation.hh"
+#include "RouletteRules.hh"
+#include "trackInformation.hh"
 
 #include "G4SteppingManager.hh"
 #include "G4EventManager.hh"
@@ -59,7 +62,7 @@ class StepMessenger;
 class SteppingAction : public G4UserSteppingAction
 {
 public:
-SteppingAction(const DetectorConstruction*, RunAction*, EventAction*);
+SteppingAction(const DetectorConstruction*, RunAction*, EventAction*, HistoManager*, const RouletteRules*, StackingAction*);
 virtual ~SteppingAction();
 
 // method from the base class
@@ -101,8 +104,11 @@ G4double weight;
 const DetectorConstruction* kdet;
 RunAction* krun;
 EventAction* kevent;
+HistoManager* khisto;
+const RouletteRules* kroulette;
+StackingAction* kstacking;
 G4OpBoundaryProcessStatus fExpectedNextStatus;
-G4String procCount;
+G4int procCount;
 G4int drawChopperIncDataFlag, drawChopperOutDataFlag, drawNRFDataFlag, drawIntObjDataFlag, drawWaterIncDataFlag, drawCherenkovDataFlag, drawDetDataFlag;
 StepMessenger* stepM;
 };
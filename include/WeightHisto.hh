@@ -30,26 +30,31 @@
 #include "G4ios.hh"
 
 #include "TROOT.h"
-#include "TApplication.h"
 #include "TSystem.h"
 #include "TH1.h"
-#include "TPad.h"
-#include "TCanvas.h"
 #include "TFile.h"
-#include "TTree.h"
-#include "TBranch.h"
-#include "TMath.h"
 #include "TString.h"
+#include "TKey.h"
+#include "RVersion.h"
+#include <ROOT/RDataFrame.hxx>
+#include <vector>
+#include <string>
+
+#if defined(MANTIS_RNTUPLE) && ROOT_VERSION_CODE < ROOT_VERSION(6,32,0)
+#include <ROOT/RNTupleDS.hxx>
+#endif
 
 class TH1D;
 class TFile;
-class TTree;
 
+// Fills the weighted NRF and optical photon energy spectra of the event correlation
+// datasets. Each dataset is read once with RDataFrame in chunks of entries so the
+// memory used does not grow with the number of entries.
 
 class WeightHisto
 {
 public:
-    WeightHisto(G4double);
+    WeightHisto(G4double, const std::vector<G4double>& binEdges, G4int nThreads = 0);
     ~WeightHisto();
     
 public:
@@ -57,13 +62,17 @@ public:
     void Fill_to_Det();
     
 private:
+    ROOT::RDataFrame MakeDataFrame(const char* name);
+    ROOT::RDF::TH1DModel Model(const char* name, const char* title) const;
+    // fill two weighted energy histograms in one pass over the dataset
+    void FillPair(const char* name, const char* energy1, const char* weight1, const char* energy2, const char* weight2,
+                  const ROOT::RDF::TH1DModel& model1, const ROOT::RDF::TH1DModel& model2);
 
     time_t timer, timer2, time_start, time_end;
-    TFile *f, *f1, *fout;
-    TTree *nrf_to_cher_tree, *nrf_to_cher_to_det_tree;
-    TH1D *wNRF_NRF_to_Cher, *wCher_NRF_to_Cher, *wNRF_to_Det, *wCher_to_Det;
+    TFile *f, *fout;
     G4double Emax;
-    std::string fileOut;
+    std::vector<G4double> edges;
+    std::string infile, fileOut;
 };
 
 #endif
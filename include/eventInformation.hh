@@ -29,6 +29,7 @@
 #include "G4ThreeVector.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4Event.hh"
+#include "G4Track.hh"
 #include "G4VUserEventInformation.hh"
 
 class eventInformation : public G4VUserEventInformation {
@@ -41,6 +42,10 @@ virtual ~eventInformation();
 inline G4double GetWeight() const {
         return weight;
 }
+// weight of the primary times the biasing weight of the track (1 without -b)
+inline G4double GetWeight(const G4Track* aTrack) const {
+        return weight*aTrack->GetWeight();
+}
 void SetWeight(G4double);
 
 inline G4double GetBeamEnergy() const {
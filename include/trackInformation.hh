@@ -0,0 +1,52 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef trackInformation_h
+#define trackInformation_h 1
+
+#include "globals.hh"
+#include "G4Track.hh"
+#include "G4VUserTrackInformation.hh"
+
+// Optical photon flags set by the StackingAction
+class trackInformation : public G4VUserTrackInformation {
+public:
+trackInformation();
+virtual ~trackInformation();
+
+// the photocathode quantum efficiency was already sampled at creation (/optical/preSampleQE)
+inline G4bool GetPreAccepted() const {
+        return preAccepted;
+}
+void SetPreAccepted(G4bool);
+
+// true if the track carries a trackInformation with the pre-accepted flag
+static G4bool IsPreAccepted(const G4Track*);
+
+void Print() const;
+private:
+G4bool preAccepted;
+};
+
+#endif
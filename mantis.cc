@@ -7,6 +7,7 @@
 // Typcially include
 #include "time.h"
 #include "Randomize.hh"
+#include "G4Version.hh"
 #include "G4Types.hh"
 
 #ifdef G4VIS_USE
@@ -19,6 +20,7 @@ G4VisManager* visManager;
 
 // For G4cout and G4cerr handling
 #include "MySession.hh"
+#include "EventCheck.hh"
 #include "G4ios.hh"
 #include "G4UIsession.hh"
 
@@ -27,9 +29,9 @@ G4long seed;
 G4double chosen_energy;
 G4bool output;
 // String global variables
-G4String macro, root_output_name, gOutName, inFile;
+G4String macro, root_output_name, gOutName, inFile, nrfBias;
 // boolean global variables 
-G4bool bremTest, resonanceTest, checkEvents, weightHisto;
+G4bool bremTest, resonanceTest, checkEvents, weightHisto, resume, opticalMap;
 
 namespace
 {
@@ -38,7 +40,9 @@ void PrintUsage()
         G4cerr << "Usage: " << G4endl;
         G4cerr << "mantis [-h help] [-m macro=mantis.in] [-a chosen_energy=-1.] [-s seed=1] [-o output_name] [-t bremTest=false] " <<
                 "[-r resonance_test=false] [-p standalone=false] [-v NRF_Verbose=false] [-n addNRF=true] " <<
-                "[-e checkEvents_in=false] [-w weightHisto_in=false] [-i inFile]"
+                "[-e checkEvents_in=false] [-w weightHisto_in=false] [-i inFile] [-c/--resume resume=false] " <<
+                "[-j join_file] [-g aggregation=first] [-x/--engine engine=ranlux (ranlux, mixmax, ranluxpp)] " <<
+                "[-b/--bias nrfBias=none (none, intobj, chopper, all)] [-d/--opticalMap opticalMap=false]"
                << G4endl;
         exit(1);
 }
@@ -55,6 +59,7 @@ int main(int argc,char **argv)
         G4String standalone_in = "false";
         G4String verbose_in = "false";
         G4String addNRF_in = "true";
+        nrfBias = "none";
         
         G4bool standalone = false;
         G4bool NRF_Verbose = false;
@@ -76,6 +81,15 @@ int main(int argc,char **argv)
         G4String weightHisto_in = "false";
         checkEvents = false;
         weightHisto = false;
+        G4String resume_in = "false";
+        resume = false;
+        G4String opticalMap_in = "false";
+        opticalMap = false;
+        // Offline Event Check Defaults
+        G4String join_file = "";
+        G4String aggregation = "first";
+        // Random engine Defaults
+        G4String engine_in = "ranlux";
 
         // Detect interactive mode (if no arguments) and define UI session
         //
@@ -86,14 +100,14 @@ int main(int argc,char **argv)
         }
 
         // Evaluate Arguments
-        if ( argc > 21)
-        {
-                PrintUsage();
-                return 1;
-        }
-
         for (G4int i=1; i<argc; i=i+2)
         {
+                // every option except -h takes a value
+                if (G4String(argv[i]) != "-h" && i+1 >= argc)
+                {
+                        PrintUsage();
+                        return 1;
+                }
                 if      (G4String(argv[i]) == "-h") PrintUsage();
                 else if (G4String(argv[i]) == "-m") macro = argv[i+1];
                 else if (G4String(argv[i]) == "-a") chosen_energy = std::stod(argv[i+1]);
@@ -107,6 +121,12 @@ int main(int argc,char **argv)
                 else if (G4String(argv[i]) == "-e") checkEvents_in = argv[i+1];
                 else if (G4String(argv[i]) == "-w") weightHisto_in = argv[i+1];
                 else if (G4String(argv[i]) == "-i") inFile = argv[i+1];
+                else if (G4String(argv[i]) == "-c" || G4String(argv[i]) == "--resume") resume_in = argv[i+1];
+                else if (G4String(argv[i]) == "-j") join_file = argv[i+1];
+                else if (G4String(argv[i]) == "-g") aggregation = argv[i+1];
+                else if (G4String(argv[i]) == "-x" || G4String(argv[i]) == "--engine") engine_in = argv[i+1];
+                else if (G4String(argv[i]) == "-b" || G4String(argv[i]) == "--bias") nrfBias = argv[i+1];
+                else if (G4String(argv[i]) == "-d" || G4String(argv[i]) == "--opticalMap") opticalMap_in = argv[i+1];
                 else
                 {
                         PrintUsage();
@@ -114,6 +134,13 @@ int main(int argc,char **argv)
                 }
         } 
         
+        // Offline Event Check of an existing output file, no simulation is run
+        if(join_file != "")
+        {
+                EventCheck eCheck(join_file, aggregation);
+                return eCheck.WriteEvents() ? 0 : 1;
+        }
+
         // Handle Output File
         std::cout << "Output Filename: " << root_output_name << std::endl;
         std::string RootOutputFile = (std::string)root_output_name;
@@ -149,6 +176,20 @@ int main(int argc,char **argv)
                 G4cout << "NRF Physics turned OFF!" << G4endl;
                 addNRF = false;
         }
+        if(nrfBias != "none" && nrfBias != "intobj" && nrfBias != "chopper" && nrfBias != "all")
+        {
+                G4cerr << "FATAL ERROR mantis.cc -> NRF biasing " << nrfBias << " not available!" << G4endl;
+                exit(1);
+        }
+        if(nrfBias != "none")
+        {
+                if(!addNRF)
+                {
+                        G4cerr << "FATAL ERROR mantis.cc -> Cannot bias NRF with NRF Physics turned OFF!" << G4endl;
+                        exit(1);
+                }
+                G4cout << "NRF Biasing set to: " << nrfBias << G4endl;
+        }
         
         // Primary Generator Options 
         if(bremTest_in == "True" || bremTest_in == "true")
@@ -169,6 +210,18 @@ int main(int argc,char **argv)
                 checkEvents = true;
         }
         
+        if(resume_in == "True" || resume_in == "true")
+        {
+                G4cout << "Resuming from the last checkpoint!" << G4endl;
+                resume = true;
+        }
+
+        if(opticalMap_in == "True" || opticalMap_in == "true")
+        {
+                G4cout << "Generating the Optical Response Map!" << G4endl;
+                opticalMap = true;
+        }
+
         if(resonance_in == "True" || resonance_in == "true")
         {
                 G4cout << "Completing Resonance Test!" << G4endl;
@@ -190,8 +243,21 @@ int main(int argc,char **argv)
         G4cout << "Seed set to: " << seed << G4endl;
         std::cout << "Seed set to: " << seed << std::endl;
 
-        // choose the Random engine
-        CLHEP::HepRandom::setTheEngine(new CLHEP::RanluxEngine);
+        // choose the Random engine, every sampling in mantis draws from it
+        if(engine_in == "mixmax")
+                CLHEP::HepRandom::setTheEngine(new CLHEP::MixMaxRng);
+#if G4VERSION_NUMBER >= 1100
+        else if(engine_in == "ranluxpp")
+                CLHEP::HepRandom::setTheEngine(new CLHEP::RanluxppEngine);
+#endif
+        else if(engine_in == "ranlux")
+                CLHEP::HepRandom::setTheEngine(new CLHEP::RanluxEngine);
+        else
+        {
+                G4cerr << "FATAL ERROR mantis.cc -> Random engine " << engine_in << " not available!" << G4endl;
+                exit(1);
+        }
+        G4cout << "Random engine set to: " << CLHEP::HepRandom::getTheEngine()->name() << G4endl;
         CLHEP::HepRandom::setTheSeed(seed);
 
         // construct the default run manager
@@ -203,7 +269,7 @@ int main(int argc,char **argv)
         runManager->SetUserInitialization(det);
 
         // Set up Physics List
-        PhysicsListNew *thePLNew = new PhysicsListNew(addNRF, use_xsec_tables, use_xsec_integration, force_isotropic, standalone, NRF_Verbose);
+        PhysicsListNew *thePLNew = new PhysicsListNew(addNRF, use_xsec_tables, use_xsec_integration, force_isotropic, standalone, NRF_Verbose, nrfBias != "none");
         runManager->SetUserInitialization(thePLNew);
 
         runManager->SetUserInitialization(new ActionInitialization(det));
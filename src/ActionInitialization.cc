@@ -28,10 +28,15 @@
 #include "RunAction.hh"
 #include "SteppingAction.hh"
 #include "StackingAction.hh"
+#include "RouletteRules.hh"
 #include "EventAction.hh"
 #include "HistoManager.hh"
+#include "OpticalMapGenerator.hh"
+#include "OpticalMapSteppingAction.hh"
 #include "G4Types.hh"
 
+extern G4bool opticalMap;
+
 
 ActionInitialization::ActionInitialization(const DetectorConstruction* det)
         : G4VUserActionInitialization(), fDetector(det)
@@ -45,13 +50,24 @@ ActionInitialization::~ActionInitialization()
 void ActionInitialization::Build() const
 {
         //std::cout << "ActionInitialization::Build() -> Begin!" << std::endl;
+        // optical map mode only fires optical photons in the water tank, no output files
+        if(opticalMap)
+        {
+                OpticalMapGenerator* generator = new OpticalMapGenerator(fDetector);
+                SetUserAction(generator);
+                SetUserAction(new OpticalMapSteppingAction(generator));
+                return;
+        }
         HistoManager* histo = new HistoManager();
-        SetUserAction(new PrimaryGeneratorAction());
+        SetUserAction(new PrimaryGeneratorAction(histo));
         RunAction* run = new RunAction(histo);
         SetUserAction(run);
-        EventAction* event = new EventAction();
+        EventAction* event = new EventAction(histo);
         SetUserAction(event);
-        SetUserAction(new SteppingAction(fDetector, run, event));
-        SetUserAction(new StackingAction(fDetector, run));
+        // shared by the stacking and stepping actions, owned by the StackingAction
+        RouletteRules* roulette = new RouletteRules();
+        StackingAction* stacking = new StackingAction(fDetector, run, event, histo, roulette);
+        SetUserAction(new SteppingAction(fDetector, run, event, histo, roulette, stacking));
+        SetUserAction(stacking);
         //std::cout << "ActionInitialization::Build() -> End!" << std::endl;
 }
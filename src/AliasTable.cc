@@ -0,0 +1,132 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AliasTable.hh"
+#include <algorithm>
+
+AliasTable::AliasTable(const TH1D* pdf, const TH1D* target)
+        : fTarget(NULL), fPdf(pdf)
+{
+        const TAxis* axis = pdf->GetXaxis();
+        G4int nbins = pdf->GetNbinsX();
+        edges.resize(nbins + 1);
+        for(G4int i=0; i<nbins; ++i)
+                edges[i] = axis->GetBinLowEdge(i+1);
+        edges[nbins] = axis->GetBinUpEdge(nbins);
+
+        // negative bins can not be sampled, TH1::GetRandom treats them the same way
+        std::vector<G4double> p(nbins, 0.);
+        G4double total = 0.;
+        for(G4int i=0; i<nbins; ++i)
+        {
+                p[i] = std::max(pdf->GetBinContent(i+1), 0.);
+                total += p[i];
+        }
+        if(total <= 0.)
+        {
+                G4cerr << "FATAL ERROR: AliasTable:: " << pdf->GetName() << " is empty." << G4endl;
+                exit(1);
+        }
+
+        // the weight is constant over a bin when both histograms share the binning
+        binWeight.assign(nbins, 1.);
+        if(target)
+        {
+                const TAxis* taxis = target->GetXaxis();
+                G4bool sameBinning = (target->GetNbinsX() == nbins && taxis->GetXmin() == axis->GetXmin()
+                                      && taxis->GetXmax() == axis->GetXmax());
+                if(sameBinning)
+                {
+                        for(G4int i=0; i<nbins; ++i)
+                                binWeight[i] = p[i] > 0. ? target->GetBinContent(i+1)/pdf->GetBinContent(i+1) : 0.;
+                }
+                else
+                {
+                        G4cout << "AliasTable::AliasTable -> " << target->GetName() << " and " << pdf->GetName()
+                               << " have different binnings. The weights are looked up per draw." << G4endl;
+                        fTarget = target;
+                }
+        }
+
+        // Vose's construction: split the bins in those below and above the mean probability
+        // and fill every small bin up with an alias to a large one
+        prob.assign(nbins, 1.);
+        alias.resize(nbins);
+        std::vector<G4int> small, large;
+        small.reserve(nbins);
+        large.reserve(nbins);
+        for(G4int i=0; i<nbins; ++i)
+        {
+                p[i] = p[i]*nbins/total;
+                alias[i] = i;
+                if(p[i] < 1.)
+                        small.push_back(i);
+                else
+                        large.push_back(i);
+        }
+        while(!small.empty() && !large.empty())
+        {
+                G4int s = small.back();
+                small.pop_back();
+                G4int l = large.back();
+                prob[s] = p[s];
+                alias[s] = l;
+                p[l] = (p[l] + p[s]) - 1.;
+                if(p[l] < 1.)
+                {
+                        large.pop_back();
+                        small.push_back(l);
+                }
+        }
+        // what is left over is 1 up to rounding
+        for(unsigned int i=0; i<small.size(); ++i)
+                prob[small[i]] = 1.;
+        for(unsigned int i=0; i<large.size(); ++i)
+                prob[large[i]] = 1.;
+
+        G4cout << "AliasTable::AliasTable -> Built alias table of " << pdf->GetName() << " with " << nbins << " bins." << G4endl;
+}
+
+AliasTable::~AliasTable()
+{
+}
+
+G4double AliasTable::Sample(G4double& weight) const
+{
+        // one random number picks the bin and decides between the bin and its alias
+        G4double u = G4UniformRand()*prob.size();
+        G4int bin = std::min((G4int) u, (G4int) prob.size() - 1);
+        if(u - bin >= prob[bin])
+                bin = alias[bin];
+
+        G4double energy = edges[bin] + (edges[bin+1] - edges[bin])*G4UniformRand();
+        if(fTarget)
+        {
+                G4double theSampling = fPdf->GetBinContent(bin+1);
+                weight = fTarget->GetBinContent(fTarget->GetXaxis()->FindBin(energy))/theSampling;
+        }
+        else
+                weight = binWeight[bin];
+        return energy;
+}
@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CherenkovStats.hh"
+#include <algorithm>
+#include <cmath>
+
+CherenkovStats::CherenkovStats()
+        : nEnergy(0), nTime(0), maxEnergy(0.), maxWeight(0.), sumEnergy(0.), sumEnergy2(0.),
+        sumTime(0.), sumTime2(0.), timeMin(0.)
+{
+}
+
+CherenkovStats::~CherenkovStats()
+{
+}
+
+void CherenkovStats::Reset()
+{
+        nEnergy = 0;
+        nTime = 0;
+        maxEnergy = 0.;
+        maxWeight = 0.;
+        sumEnergy = 0.;
+        sumEnergy2 = 0.;
+        sumTime = 0.;
+        sumTime2 = 0.;
+        timeMin = 0.;
+}
+
+void CherenkovStats::AddEnergy(G4double energy, G4double weight)
+{
+        // the first step with the max energy keeps its weight, as std::max_element did
+        if(nEnergy == 0 || energy > maxEnergy)
+        {
+                maxEnergy = energy;
+                maxWeight = weight;
+        }
+        ++nEnergy;
+        sumEnergy += energy;
+        sumEnergy2 += energy*energy;
+}
+
+void CherenkovStats::AddTime(G4double time)
+{
+        if(nTime == 0 || time < timeMin)
+                timeMin = time;
+        ++nTime;
+        sumTime += time;
+        sumTime2 += time*time;
+}
+
+G4double CherenkovStats::GetMeanEnergy() const
+{
+        return nEnergy > 0 ? sumEnergy/nEnergy : 0.;
+}
+
+G4double CherenkovStats::GetEnergyRMS() const
+{
+        if(nEnergy == 0)
+                return 0.;
+        G4double mean = sumEnergy/nEnergy;
+        return std::sqrt(std::max(0., sumEnergy2/nEnergy - mean*mean));
+}
+
+G4double CherenkovStats::GetMeanTime() const
+{
+        return nTime > 0 ? sumTime/nTime : 0.;
+}
+
+G4double CherenkovStats::GetTimeRMS() const
+{
+        if(nTime == 0)
+                return 0.;
+        G4double mean = sumTime/nTime;
+        return std::sqrt(std::max(0., sumTime2/nTime - mean*mean));
+}
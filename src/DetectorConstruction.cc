@@ -23,20 +23,23 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "DetectorConstruction.hh"
+#include "G4NRF.hh"
+#include <sstream>
 
 extern G4bool bremTest;
+extern G4String nrfBias;
 
 DetectorConstruction::DetectorConstruction()
         : G4VUserDetectorConstruction(), // chopper properties
-        chopperDensity(19.1*g/cm3), chopper_thick(30*mm), chopper_z(2*cm), chopperOn(false), // interrogation object properties
+        chopperDensity(19.1*g/cm3), chopper_thick(30*mm), chopper_z(2*cm), chopperOn(false), nChopperBuilds(0), // interrogation object properties
         IntObj_rad(4.5*cm), intObjDensity(19.1*g/cm3), intObj_x_pos(0*cm), intObj_y_pos(0*cm), intObj_z_pos(0*cm), IntObj_Selection("Uranium"), // radio abundances
-        chopper_radio_abundance(0), intObj_radio_abundance(0), // Attenuator Properties
+        chopper_radio_abundance(0), intObj_radio_abundance(0), logicChopper(NULL), logicIntObj(NULL), // Attenuator Properties
         attenuatorState(false), attenuatorState2(false), attenThickness(0.1*mm), attenThickness2(0.1*mm), attenuatorMat("G4_AIR"), attenuatorMat2("G4_AIR"), // Water Tank properties
         theAngle(120.0), water_size_x(60*cm), water_size_y(2.5908*m), water_size_z(40*cm), // plexi/tape properties
         plexiThickness(0.18*mm), tapeThick(0.01*cm), // PMT Properties
         PMT_rmax(25.4*cm), nPMT(4), pc_mat("GaAsP"), // Output Properties
         DetectorViewOnly(false), material_verbose(false), checkOverlaps(true), // Messenger
-        detectorM(NULL)
+        detectorM(NULL), fNRFBias(NULL), nrfForcing(5.)
 {
         detectorM = new DetectorMessenger(this);
 }
@@ -100,8 +103,6 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
         G4Isotope* Tungsten186 = new G4Isotope("Tung186", 74, 186, 185.9543*g/mole);
         
 // Setting up Chopper Materials 
-        G4Element* Uranium_chopper = new G4Element("Chopper_Uranium", "U", 2); // name, element symbol, #isotopes
-        G4Element* Plutonium_chopper = new G4Element("Chopper_Plutonium","Pu",2);
         G4Element* Lead_chopper = new G4Element("Chopper_Lead","Pb",4);
         Lead_chopper->AddIsotope(Lead204, 1.4*perCent);
         Lead_chopper->AddIsotope(Lead206, 24.1*perCent);
@@ -186,72 +187,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
         }
 
         G4Tubs *solidChopper = new G4Tubs("Chop", 0*cm, 15*cm, chopper_thick/2, 0.*deg, 180.*deg);
-        G4Material *chopperMat = new G4Material("chopperMaterial", chopperDensity, 1);
-        G4cout << "The Chopper State was set to: " << chopperOn << G4endl;
-
-        if(chopperDensity == 19.1*g/cm3)
-        {
-                if(chopper_radio_abundance <= 0.0)
-                {
-                        G4cerr << "Fatal Error: User Must input chopper isotope abundance as percentage > 0" << G4endl;
-                        exit(100);
-                }
-
-                if(chopperOn)
-                {
-                        chopper_U235_abundance = chopper_radio_abundance;
-                        chopper_U238_abundance = 100. - chopper_radio_abundance;
-                }
-                else
-                {
-                        chopper_U235_abundance = 100. - chopper_radio_abundance;
-                        chopper_U238_abundance = chopper_radio_abundance;     
-                }
-
-                Uranium_chopper->AddIsotope(Uranium235, chopper_U235_abundance*perCent);
-                Uranium_chopper->AddIsotope(Uranium238, chopper_U238_abundance*perCent);
-                chopperMat->AddElement(Uranium_chopper,1);
-                G4cout << "The Chopper material selected was: Uranium" << G4endl;
-                G4cout << "The Chopper fission isotope abundance was set to: " << chopper_radio_abundance << " %" << G4endl;
-        }
-        else if(chopperDensity == 19.6*g/cm3)
-        {
-                if(chopper_radio_abundance <= 0.0)
-                {
-                        G4cerr << "Fatal Error: User Must input chopper isotope abundance as percentage > 0" << G4endl;
-                        exit(100);
-                }
-
-                if(chopperOn)
-                {
-                        chopper_Pu239_abundance = chopper_radio_abundance;
-                        chopper_Pu240_abundance = 100. - chopper_radio_abundance;      
-                }
-                else
-                {
-                        chopper_Pu239_abundance = 100. - chopper_radio_abundance;
-                        chopper_Pu240_abundance = chopper_radio_abundance;       
-                }
-
-                Plutonium_chopper->AddIsotope(Plutonium239, chopper_Pu239_abundance*perCent);
-                Plutonium_chopper->AddIsotope(Plutonium240, chopper_Pu240_abundance*perCent);
-                chopperMat->AddElement(Plutonium_chopper, 1);
-                G4cout << "The Chopper material selected was: Plutonium" << G4endl;
-                G4cout << "The Chopper fission isotope abundance was set to: " << chopper_radio_abundance << " %" << G4endl;
-        }
-        else if(chopperDensity == 11.34*g/cm3)
-        {
-                chopperMat->AddElement(Lead_chopper,1);
-                G4cout << "The Chopper material selected was: Lead" << G4endl;
-        }
-        else if(chopperDensity == 19.3*g/cm3)
-        {
-                chopperMat->AddElement(Tungsten_chopper,1);
-                G4cout << "The Chopper material selected was: Tungsten" << G4endl;
-        }
-        else{G4cerr << "ERROR Chopper Density not found!" << G4endl; exit(100);}
-
-        G4cout << "The Chopper material density selected was: " << chopperDensity/(g/cm3) << " g/cm3" << G4endl;
+        G4Material *chopperMat = BuildChopperMaterial();
 
 
         G4cout << "The Chopper thickness was: " << chopper_thick/(mm) << " mm" << G4endl;
@@ -408,7 +344,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
                 G4cout << "The User's Interrogation Object Density: " << intObjDensity/(g/cm3) << " g/cm3" << G4endl;
                 G4cout << "The User's Interrogation Object Location: (" << intObj_x_pos/(cm) << ", " << intObj_y_pos/(cm) << ", " << intObj_z_pos/(cm) << ")" << " cm" << G4endl;
 
-                G4LogicalVolume* logicIntObj = new G4LogicalVolume(solidIntObj, intObjMat,"IntObj");
+                logicIntObj = new G4LogicalVolume(solidIntObj, intObjMat,"IntObj");
                 G4cout << "Begin of Interrogation Object: " << container_z_pos/(cm) + intObj_z_pos/(cm) -  IntObj_rad/(cm) << " cm" << G4endl;
                 setEndIntObj(container_z_pos, 2.4384*m);
 
@@ -448,6 +384,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
                 waterRot->rotateY((180. - theAngle)*deg);
                 G4RotationMatrix* waterRot2 = new G4RotationMatrix;
                 waterRot2->rotateY((180. + theAngle)*deg);
+                // NRF splitting aims at the tanks
+                G4NRF::SetSplittingAngle(theAngle*deg);
 
                 new G4PVPlacement(waterRot,
                                   G4ThreeVector(water_x_pos,0,water_z_pos), logicAttenuator,
@@ -970,3 +908,128 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
         return physWorld;
 }
 /* ************************************************************************************ */
+
+// ******************************************************************************************************************************** //
+// Chopper Material
+// ******************************************************************************************************************************** //
+
+G4Material* DetectorConstruction::BuildChopperMaterial()
+{
+        // the first chopper material keeps its original name, materials built for later runs are numbered
+        G4String matName = "chopperMaterial";
+        G4String suffix = "";
+        if(nChopperBuilds > 0)
+                suffix = "_" + std::to_string(nChopperBuilds);
+        matName += suffix;
+        G4Material *chopperMat = new G4Material(matName, chopperDensity, 1);
+        G4cout << "The Chopper State was set to: " << chopperOn << G4endl;
+
+        if(chopperDensity == 19.1*g/cm3)
+        {
+                if(chopper_radio_abundance <= 0.0)
+                {
+                        G4cerr << "Fatal Error: User Must input chopper isotope abundance as percentage > 0" << G4endl;
+                        exit(100);
+                }
+
+                if(chopperOn)
+                {
+                        chopper_U235_abundance = chopper_radio_abundance;
+                        chopper_U238_abundance = 100. - chopper_radio_abundance;
+                }
+                else
+                {
+                        chopper_U235_abundance = 100. - chopper_radio_abundance;
+                        chopper_U238_abundance = chopper_radio_abundance;     
+                }
+
+                G4Element* Uranium_chopper = new G4Element("Chopper_Uranium" + suffix, "U", 2); // name, element symbol, #isotopes
+                Uranium_chopper->AddIsotope(G4Isotope::GetIsotope("Uranium235"), chopper_U235_abundance*perCent);
+                Uranium_chopper->AddIsotope(G4Isotope::GetIsotope("Uranium238"), chopper_U238_abundance*perCent);
+                chopperMat->AddElement(Uranium_chopper,1);
+                G4cout << "The Chopper material selected was: Uranium" << G4endl;
+                G4cout << "The Chopper fission isotope abundance was set to: " << chopper_radio_abundance << " %" << G4endl;
+        }
+        else if(chopperDensity == 19.6*g/cm3)
+        {
+                if(chopper_radio_abundance <= 0.0)
+                {
+                        G4cerr << "Fatal Error: User Must input chopper isotope abundance as percentage > 0" << G4endl;
+                        exit(100);
+                }
+
+                if(chopperOn)
+                {
+                        chopper_Pu239_abundance = chopper_radio_abundance;
+                        chopper_Pu240_abundance = 100. - chopper_radio_abundance;      
+                }
+                else
+                {
+                        chopper_Pu239_abundance = 100. - chopper_radio_abundance;
+                        chopper_Pu240_abundance = chopper_radio_abundance;       
+                }
+
+                G4Element* Plutonium_chopper = new G4Element("Chopper_Plutonium" + suffix, "Pu", 2);
+                Plutonium_chopper->AddIsotope(G4Isotope::GetIsotope("Plutonium239"), chopper_Pu239_abundance*perCent);
+                Plutonium_chopper->AddIsotope(G4Isotope::GetIsotope("Plutonium240"), chopper_Pu240_abundance*perCent);
+                chopperMat->AddElement(Plutonium_chopper, 1);
+                G4cout << "The Chopper material selected was: Plutonium" << G4endl;
+                G4cout << "The Chopper fission isotope abundance was set to: " << chopper_radio_abundance << " %" << G4endl;
+        }
+        else if(chopperDensity == 11.34*g/cm3)
+        {
+                chopperMat->AddElement(G4Element::GetElement("Chopper_Lead"),1);
+                G4cout << "The Chopper material selected was: Lead" << G4endl;
+        }
+        else if(chopperDensity == 19.3*g/cm3)
+        {
+                chopperMat->AddElement(G4Element::GetElement("Chopper_Tungsten"),1);
+                G4cout << "The Chopper material selected was: Tungsten" << G4endl;
+        }
+        else{G4cerr << "ERROR Chopper Density not found!" << G4endl; exit(100);}
+
+        G4cout << "The Chopper material density selected was: " << chopperDensity/(g/cm3) << " g/cm3" << G4endl;
+        ++nChopperBuilds;
+        return chopperMat;
+}
+
+void DetectorConstruction::UpdateChopperMaterial()
+{
+        // before /run/initialize Construct builds the chopper with the new settings
+        if(!logicChopper)
+                return;
+        G4cout << G4endl << "DetectorConstruction::UpdateChopperMaterial -> Rebuilding the Chopper Material" << G4endl;
+        G4cout << "----------------------------------------------------------------------" << G4endl;
+        logicChopper->SetMaterial(BuildChopperMaterial());
+        // the physics tables of all particles are rebuilt at the next beamOn,
+        // the geometry and the NRF level store are kept
+        G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+}
+
+void DetectorConstruction::ConstructSDandField()
+{
+        if(nrfBias == "none")
+                return;
+        if(!fNRFBias)
+                fNRFBias = new NRFBiasingOperator();
+        fNRFBias->SetForcing(nrfForcing);
+        if((nrfBias == "intobj" || nrfBias == "all") && logicIntObj)
+        {
+                fNRFBias->AttachTo(logicIntObj);
+                G4cout << "DetectorConstruction::ConstructSDandField -> Forcing NRF in the Interrogation Object" << G4endl;
+        }
+        if((nrfBias == "chopper" || nrfBias == "all") && logicChopper)
+        {
+                fNRFBias->AttachTo(logicChopper);
+                G4cout << "DetectorConstruction::ConstructSDandField -> Forcing NRF in the Chopper" << G4endl;
+        }
+}
+
+G4String DetectorConstruction::GetOpticalSignature() const
+{
+        std::ostringstream signature;
+        signature << "WaterX=" << water_size_x/(cm) << ";WaterY=" << water_size_y/(cm) << ";WaterZ=" << water_size_z/(cm)
+                  << ";nPMT=" << nPMT << ";PCrad=" << PMT_rmax/(cm) << ";PCmat=" << pc_mat
+                  << ";Tape=" << tapeThick/(cm) << ";Plexi=" << plexiThickness/(mm);
+        return signature.str();
+}
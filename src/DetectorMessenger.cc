@@ -22,6 +22,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "DetectorMessenger.hh"
+#include "G4StateManager.hh"
+#include "G4NRF.hh"
 
 
 DetectorMessenger::DetectorMessenger(DetectorConstruction* DetectorAction)
@@ -44,12 +46,15 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* DetectorAction)
         Cmdtr = new G4UIcmdWithADouble("/mytar/IntObjRad",this);
         Cmdtrad = new G4UIcmdWithADouble("/mytar/abundance",this);
         Cmdtsel = new G4UIcmdWithAString("/mytar/target",this);
+        CmdNRFForcing = new G4UIcmdWithADouble("/mytar/nrfForcing",this);
         CmdtXpos = new G4UIcmdWithADouble("/mytar/IntObjXPos",this);
         CmdtYpos = new G4UIcmdWithADouble("/mytar/IntObjYPos",this);
         CmdtZpos = new G4UIcmdWithADouble("/mytar/IntObjZPos",this);
         Cmdpcmat = new G4UIcmdWithAString("/mydet/PCmat",this);
         CmdnPMT = new G4UIcmdWithAnInteger("/mydet/nPMT",this);
         CmdAngle = new G4UIcmdWithADouble("/mydet/Angle",this);
+        CmdNRFSplit = new G4UIcmdWithAnInteger("/mydet/nrfSplitting",this);
+        CmdNRFSplitWindow = new G4UIcmdWithADouble("/mydet/nrfSplittingWindow",this);
         CmdChopMaterial = new G4UIcmdWithAString("/chopper/material",this);
         CmdChopthick = new G4UIcmdWithADouble("/chopper/thickness", this);
         CmdChopZ = new G4UIcmdWithADouble("/chopper/distance", this);
@@ -75,6 +80,7 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* DetectorAction)
         Cmdtr->SetGuidance("Choose Desired radius Size of Interogation Target");
         Cmdtrad->SetGuidance("Choose Desired fission isotope abundance(enrichment) of Interrogation Target");
         Cmdtsel->SetGuidance("Choose Desired target");
+        CmdNRFForcing->SetGuidance("Choose the number of NRF interaction lengths forced into the biased volumes with -b (default 5)");
         CmdtXpos->SetGuidance("Choose Desired X Position of Interogation Target");
         CmdtYpos->SetGuidance("Choose Desired Y Position of Interogation Target");
         CmdtZpos->SetGuidance("Choose Desired Z Position of Interogation Target");
@@ -86,6 +92,8 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* DetectorAction)
         CmdChopperOn->SetGuidance("Choose desired chopper wheel state");
         CmdChopperAbundance->SetGuidance("Choose desired chopper wheel material isotope abundance(enrichment)");
         CmdAngle->SetGuidance("Choose desired Detector BackScatter Angle in Degrees");
+        CmdNRFSplit->SetGuidance("Choose the number of weighted copies of every NRF emitted gamma (default 1, no splitting)");
+        CmdNRFSplitWindow->SetGuidance("Choose the half angle in Degrees of the cones around the water tanks in which all NRF copies are kept (default 30)");
         CmdAttenOn->SetGuidance("Choose if Attenuator Present or not");
         CmdAttenThick->SetGuidance("Choose Desired attenuator thickness");
         CmdAttenMat->SetGuidance("Choose desired attenuator material from NIST materials");
@@ -104,6 +112,8 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* DetectorAction)
         Cmdtrad->SetParameterName("targetabundance",false);
         Cmdtrad->SetRange("targetabundance > 0 && targetabundance < 100");
         Cmdtsel->SetParameterName("targetsel",false);
+        CmdNRFForcing->SetParameterName("forcing",false);
+        CmdNRFForcing->SetRange("forcing > 0");
         CmdtXpos->SetParameterName("targetxpos",false);
         CmdtYpos->SetParameterName("targetypos",false);
         CmdtZpos->SetParameterName("targetzpos",false);
@@ -118,6 +128,10 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* DetectorAction)
         CmdChopperAbundance->SetRange("chopperAbundance > 0 && chopperAbundance < 100");
         CmdAngle->SetParameterName("Angle",false);
         CmdAngle->SetRange("Angle > 90 && Angle < 135");
+        CmdNRFSplit->SetParameterName("nSplit",false);
+        CmdNRFSplit->SetRange("nSplit >= 1");
+        CmdNRFSplitWindow->SetParameterName("splitWindow",false);
+        CmdNRFSplitWindow->SetRange("splitWindow > 0 && splitWindow <= 180");
         CmdAttenOn->SetParameterName("attenuator",false);
         CmdAttenThick->SetParameterName("attenThickness",false);
         CmdAttenMat->SetParameterName("attenMaterial",false);
@@ -152,6 +166,7 @@ DetectorMessenger::~DetectorMessenger()
         delete Cmdtr;
         delete Cmdtrad;
         delete Cmdtsel;
+        delete CmdNRFForcing;
         delete CmdtXpos;
         delete CmdtYpos;
         delete CmdtZpos;
@@ -162,6 +177,8 @@ DetectorMessenger::~DetectorMessenger()
         delete CmdChopperOn;
         delete CmdChopperAbundance;
         delete CmdAngle;
+        delete CmdNRFSplit;
+        delete CmdNRFSplitWindow;
         delete CmdAttenOn;
         delete CmdAttenThick;
         delete CmdAttenMat;
@@ -221,6 +238,12 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
                 DetectorA->SetIntObj(theCommandtsel);
                 G4cout << "The Interrogation Object manually set to: " << theCommandtsel << " material!" << G4endl << G4endl;
         }
+        else if(command == CmdNRFForcing)
+        {
+                G4double theForcing = CmdNRFForcing->GetNewDoubleValue(newValue);
+                DetectorA->SetNRFForcing(theForcing);
+                G4cout << "The NRF forcing manually set to: " << theForcing << " interaction lengths" << G4endl;
+        }
         else if(command == CmdtXpos)
         {
                 G4double theCommandtXpos = CmdtXpos->GetNewDoubleValue(newValue);
@@ -276,12 +299,14 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
                         DetectorA->SetChopperOn(false);
                         G4cout << "The Chopper state set to Off!" << G4endl;
                 }
+                UpdateChopper();
         }
         else if(command == CmdChopperAbundance)
         {
                 G4double thechopperabundance = CmdChopperAbundance->GetNewDoubleValue(newValue);
                 DetectorA->SetChopperAbundance(thechopperabundance);
                 G4cout << "The Chopper isotope abundance manually set to: " << thechopperabundance << " percent" << G4endl;
+                UpdateChopper();
         }
         else if(command == CmdAngle)
         {
@@ -289,6 +314,18 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
                 DetectorA->SettheAngle(thecmdAngle);
                 G4cout << "The Detector angle manually set to: " << thecmdAngle << " degrees" << G4endl;
         }
+        else if(command == CmdNRFSplit)
+        {
+                G4int theSplit = CmdNRFSplit->GetNewIntValue(newValue);
+                G4NRF::SetSplitting(theSplit);
+                G4cout << "The NRF gamma splitting manually set to: " << theSplit << " copies" << G4endl;
+        }
+        else if(command == CmdNRFSplitWindow)
+        {
+                G4double theWindow = CmdNRFSplitWindow->GetNewDoubleValue(newValue);
+                G4NRF::SetSplittingWindow(theWindow*deg);
+                G4cout << "The NRF splitting window manually set to: " << theWindow << " degrees" << G4endl;
+        }
         else if(command == CmdAttenOn)
         {
                 G4String theCmdAttenOn = newValue;
@@ -383,6 +420,7 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
                 G4String theCmdChopMaterial = newValue;
                 DetectorA->SetChopperMaterial(theCmdChopMaterial);
                 G4cout << "The chopper material manually set to: " << theCmdChopMaterial << G4endl;
+                UpdateChopper();
         }
         else if(command == CmdVerbose)
         {
@@ -411,3 +449,10 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
                 G4cerr << "ERROR DetectorMessenger :: SetDetectorInputValue command != Cmd" << G4endl;
         }
 }
+
+void DetectorMessenger::UpdateChopper()
+{
+        // between runs the chopper material is replaced and the physics tables are rebuilt, the geometry stays initialised
+        if(G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle)
+                DetectorA->UpdateChopperMaterial();
+}
@@ -23,8 +23,10 @@
 
 #include "EventAction.hh"
 extern G4bool weightHisto;
+extern G4bool checkEvents;
 
-EventAction::EventAction()
+EventAction::EventAction(HistoManager* histoAnalysis)
+        : fHistoManager(histoAnalysis)
 {
 }
 
@@ -36,8 +38,9 @@ void EventAction::BeginOfEventAction(const G4Event*)
 {
         //std::cout << "EventAction::BeginOfEventAction -> Beginning" << std::endl;
         c_secondaries = 0;
-        energyv.clear();
-        timev.clear();
+        cherStats.Reset();
+        nrfFlag = false;
+        detFlag = false;
         //std::cout << "EventAction::BeginOfEventAction -> Ending" << std::endl;
 }
 
@@ -47,30 +50,24 @@ void EventAction::EndOfEventAction(const G4Event* anEvent)
         if(c_secondaries > 0)
         {
                 // Grab Max Energy
-                G4double maxE = *std::max_element(energyv.begin(),energyv.end());
-                // Find Max Energy's Weight
-                eventInformation* info = (eventInformation*)(G4RunManager::GetRunManager()->GetCurrentEvent()->GetUserInformation());
-                G4double weight = info->GetWeight();
-                // Find the Average Time
-                G4double c_time;
-                if(timev.size() > 0)
+                G4double maxE = cherStats.GetMaxEnergy();
+                // Find Max Energy's Weight, differs from the event weight only with NRF biasing
+                G4double weight = cherStats.GetMaxWeight();
+                // Fill the TTree with the average, earliest and rms time
+                fHistoManager->FillCherenkov(anEvent->GetEventID(), maxE, weight, c_secondaries, cherStats.GetMeanTime(),
+                                             cherStats.GetTimeMin(), cherStats.GetTimeRMS());
+                if(weightHisto)
                 {
-                        c_time = calcAvg();
+                        fHistoManager->FillH1(9, maxE, weight);
                 }
-                else
-                        c_time = 0;
-                // Fill the TTree
-                G4AnalysisManager* manager = G4AnalysisManager::Instance();
-                manager->FillNtupleDColumn(3,0,maxE);
-                manager->FillNtupleDColumn(3,1, weight);
-                manager->FillNtupleIColumn(3,2,anEvent->GetEventID());
-                manager->FillNtupleIColumn(3,3,c_secondaries);
-                manager->FillNtupleDColumn(3,4,c_time);
-                manager->AddNtupleRow(3);
-                if(weightHisto)
+                // Write the event correlations, the max energy is taken as the optical photon energy
+                if(checkEvents && nrfFlag)
                 {
-                        manager->FillH1(9, maxE, weight);
+                        fHistoManager->FillNRFToCher(anEvent->GetEventID(), nrfEnergy, nrfWeight, maxE, weight);
+                        if(detFlag)
+                                fHistoManager->FillNRFToCherToDet(anEvent->GetEventID(), nrfEnergy, nrfWeight, maxE, weight, nrfTime, detTime);
                 }
         }
+        fHistoManager->EndOfEvent(anEvent->GetEventID());
         //std::cout << "EventAction::EndOfEventAction() --> Ending!" << std::endl;
 }
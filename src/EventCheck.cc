@@ -24,302 +24,315 @@
 //
 // File Explanation:
 //
-// This File Scans the Cherenkov Merged File and determines:
+// This File Scans a mantis output file and determines:
 // 1. Check if a NRF event causes cherenkov
-// 2. Check if a NRF event was detected
-// 3. Check if a Cherenkov event was detected
-// 4. Check if a NRF event lead to Cherenkov which was then detected
+// 2. Check if a NRF event lead to Cherenkov which was then detected
 //
-// The script create a new root file with the Following Structure:
-// TFile**        test_EventCheck.root
-// TFile*        test_EventCheck.root
+// The NRFMatData, Cherenkov and DetInfo datasets are written in EventID order so
+// the events are matched with a single streaming merge over the three datasets of
+// each input file. Merged files restart the EventID with every run, the Seed column
+// tells the runs apart. Several output files are joined one file at a time.
+//
+// The script creates two new root files with the Following Structure:
+// TFile**        test_NRF_to_Cher.root          nrf_to_cher_tree
+// TFile**        test_NRF_to_Cher_to_Det.root   nrf_to_cher_to_det_tree
 
 #include "EventCheck.hh"
 
-extern G4String root_output_name;
-extern G4String gOutName;
+// ******************************************************************************************************************************** //
+// Event Stream
+// ******************************************************************************************************************************** //
 
-EventCheck::EventCheck()
+EventStream::EventStream(TFile* f, const char* name, const char* timeColumn,
+                         const char* selColumn, const std::vector<G4int>& selCodes)
+        : fDone(true), fUnordered(false), fRowsRead(0), fSelCodes(selCodes), fEntry(0), fEntries(0), fRunRank(0), fTree(0),
+        bEventID(0), bCode(0), bSeed(0), bEnergy(0.), bWeight(0.), bTime(0.), hasTime(TString(timeColumn) != ""), hasSeed(false)
 {
-        time_start = std::time(&timer);
-
-        if(gSystem->AccessPathName(root_output_name.c_str()))
+        fHead.rank = -1;
+        fHead.eventID = -1;
+        TKey *key = f->GetKey(name);
+        if(!key)
         {
-                std::cerr << "EventCheck::EventCheck -> File: " << root_output_name << " does not exist." << std::endl;
-                G4cerr << "EventCheck::EventCheck -> File: " << root_output_name << " does not exist." << G4endl;
+                G4cerr << "EventStream::EventStream -> " << name << " not found in " << f->GetName() << G4endl;
                 return;
         }
-        else
+
+        if(TString(key->GetClassName()).Contains("RNTuple"))
         {
-                std::cout << "EventCheck::EventCheck -> File: " << root_output_name << " exists." << std::endl;
-                G4cout << "EventCheck::EventCheck -> File: " << root_output_name << " exists." << G4endl;
+#ifdef MANTIS_RNTUPLE
+                fReader = RNT::RNTupleReader::Open(name, f->GetName());
+                fEntries = fReader->GetNEntries();
+                fEventIDView.reset(new RNT::RNTupleView<G4int>(fReader->GetView<G4int>("EventID")));
+                fEnergyView.reset(new RNT::RNTupleView<G4double>(fReader->GetView<G4double>("Energy")));
+                fWeightView.reset(new RNT::RNTupleView<G4double>(fReader->GetView<G4double>("Weight")));
+                if(hasTime)
+                        fTimeView.reset(new RNT::RNTupleView<G4double>(fReader->GetView<G4double>(timeColumn)));
+                if(!fSelCodes.empty())
+                        fCodeView.reset(new RNT::RNTupleView<G4int>(fReader->GetView<G4int>(selColumn)));
+                // RNTuple output was added with the Seed column
+                hasSeed = true;
+                fSeedView.reset(new RNT::RNTupleView<G4int>(fReader->GetView<G4int>("Seed")));
+#else
+                G4cerr << "EventStream::EventStream -> mantis was built without RNTuple support, cannot read " << name << G4endl;
+                return;
+#endif
         }
-        f = new TFile(root_output_name.c_str());
-        bool confirm = f->cd();
-        if(confirm)
+        else
         {
-                //Cherenkov->Print();
-                f->GetObject("Cherenkov",Cherenkov);
-                //Cherenkov->Print();
-                f->GetObject("NRFMatData",NRF);
-                //NRF->Print();
-                f->GetObject("DetInfo",DetData);
-                //DetData->Print();
-
-                Cherenkov->SetEstimate(-1);
-                NRF->SetEstimate(-1);
-                DetData->SetEstimate(-1);
+                f->GetObject(name, fTree);
+                fEntries = fTree->GetEntries();
+                // files written before the NRFMatData Time column have no NRF time
+                if(hasTime && !fTree->GetBranch(timeColumn))
+                        hasTime = false;
+                // files written before the Seed column are a single run unless they were merged
+                hasSeed = (fTree->GetBranch("Seed") != 0);
+                // only read the joined branches, cluster by cluster
+                fTree->SetBranchStatus("*", 0);
+                fTree->SetCacheSize(32*1024*1024);
+                std::vector<std::string> branches = {"EventID", "Energy", "Weight"};
+                fTree->SetBranchAddress("EventID", &bEventID);
+                fTree->SetBranchAddress("Energy", &bEnergy);
+                fTree->SetBranchAddress("Weight", &bWeight);
+                if(hasTime)
+                {
+                        fTree->SetBranchAddress(timeColumn, &bTime);
+                        branches.push_back(timeColumn);
+                }
+                if(!fSelCodes.empty())
+                {
+                        fTree->SetBranchAddress(selColumn, &bCode);
+                        branches.push_back(selColumn);
+                }
+                if(hasSeed)
+                {
+                        fTree->SetBranchAddress("Seed", &bSeed);
+                        branches.push_back("Seed");
+                }
+                for(unsigned int i=0; i<branches.size(); ++i)
+                {
+                        fTree->SetBranchStatus(branches[i].c_str(), 1);
+                        fTree->AddBranchToCache(branches[i].c_str(), kTRUE);
+                }
         }
 
-        G4cout << "EventCheck::EventCheck -> Objects Grabbed!" << G4endl;
-
-        // Grab Cherenkov Events
-        num_entries = Cherenkov->Draw("EventID:Energy:Weight","","goff");
-        G4cout << "EventCheck::EventCheck -> Cherenkov Entries: " << num_entries << G4endl;
-        G4double *cherEvent = Cherenkov->GetVal(0);
-        G4double *cherEnergy = Cherenkov->GetVal(1);
-        G4double *cherWeight = Cherenkov->GetVal(2);
-
-        for(int i=0; i<num_entries; ++i)
-        {
-                cherEventv.push_back((int)cherEvent[i]);
-        }
+        fDone = false;
+}
 
-        // Grab NRF Events
-        num_entries1 = NRF->Draw("EventID:Energy:Weight","","goff");
-        G4cout << "EventCheck::EventCheck -> NRF Entries: " << num_entries1 << G4endl;
-        G4double *nrfEvent = NRF->GetVal(0);
-        G4double *nrfEnergy = NRF->GetVal(1);
-        G4double *nrfWeight = NRF->GetVal(2);
+EventStream::~EventStream()
+{
+}
 
-        for(int i=0; i<num_entries1; ++i)
+G4bool EventStream::ScanRuns(std::vector<G4int>& runs)
+{
+        if(fDone || !hasSeed)
+                return true;
+        // only the Seed column is read, it compresses to almost nothing
+        TBranch* seedBranch = fTree ? fTree->GetBranch("Seed") : 0;
+        std::vector<G4int> seen;
+        for(Long64_t i=0; i<fEntries; ++i)
         {
-                nrfEventv.push_back((int)nrfEvent[i]);
+#ifdef MANTIS_RNTUPLE
+                if(fReader)
+                        bSeed = (*fSeedView)(i);
+                else
+#endif
+                seedBranch->GetEntry(i);
+                if(!seen.empty() && seen.back() == bSeed)
+                        continue;
+                if(std::find(seen.begin(), seen.end(), bSeed) != seen.end())
+                {
+                        G4cerr << "ERROR EventStream::ScanRuns -> Seed " << bSeed << " appears in two runs of the file." << G4endl;
+                        return false;
+                }
+                seen.push_back(bSeed);
         }
+        runs.insert(runs.end(), seen.begin(), seen.end());
+        return true;
+}
 
-        // Grab DetInfo Events
-        num_entries2 = DetData->Draw("EventID:Energy:Weight:Time","CreatorProcess == \"Scintillation\" || CreatorProcess == \"Cerenkov\"","goff");
-        G4cout << "EventCheck::EventCheck -> Total Number of Detected Optical Photon entries: " << num_entries2 << G4endl << G4endl;
-        G4double *detEvent = DetData->GetVal(0);
-        G4double *detEnergy = DetData->GetVal(1);
-        G4double *detWeight = DetData->GetVal(2);
-        G4double *time = DetData->GetVal(3);
-
-        for(int i=0; i<num_entries2; ++i)
-        {
-                detEventv.push_back((int)detEvent[i]);
-        }
+void EventStream::Start(const std::map<G4int, G4int>& runRank)
+{
+        fRunRank = &runRank;
+        if(!fDone)
+                Advance();
+}
 
-        if(num_entries != 0 && num_entries1 != 0)
+void EventStream::Advance()
+{
+        EventKey lastKey = GetKey();
+        while(fEntry < fEntries)
         {
-                G4cout << "EventCheck::EventCheck -> Finding NRF Events that Caused Optical Photons..." << G4endl;
-                // if Cherenkov has more entries search with nrf events
-                if(num_entries1 < num_entries)
+                Long64_t i = fEntry++;
+#ifdef MANTIS_RNTUPLE
+                if(fReader)
                 {
-                        for(int i=0; i<num_entries1; ++i)
-                        {
-                                x = nrfEventv[i];
-                                auto exists = std::find(cherEventv.begin(),cherEventv.end(), x);
-
-                                if(exists != cherEventv.end())
-                                {
-                                        index = exists - cherEventv.begin();
-                                        nrf_to_cherEvents.push_back(x);
-                                        nrfEnergyv.push_back(nrfEnergy[i]);
-                                        nrfWeightv.push_back(nrfWeight[i]);
-                                        cherEnergyv.push_back(cherEnergy[index]);
-                                        cherWeightv.push_back(cherWeight[index]);
-                                }
-                        }
+                        bEventID = (*fEventIDView)(i);
+                        bEnergy = (*fEnergyView)(i);
+                        bWeight = (*fWeightView)(i);
+                        if(hasTime)
+                                bTime = (*fTimeView)(i);
+                        if(fCodeView)
+                                bCode = (*fCodeView)(i);
                 }
-                // Else NRF has more entries search with cherenkov events
                 else
-                {
-                        for(int i=0; i<num_entries; ++i)
-                        {
-                                x = cherEventv[i];
-                                auto exists = std::find(nrfEventv.begin(),nrfEventv.end(), x);
+#endif
+                fTree->GetEntry(i);
 
-                                if(exists != nrfEventv.end())
-                                {
-                                        index = exists - nrfEventv.begin();
-                                        nrf_to_cherEvents.push_back(x);
-                                        cherEnergyv.push_back(cherEnergy[i]);
-                                        cherWeightv.push_back(cherWeight[i]);
-                                        nrfEnergyv.push_back(nrfEnergy[index]);
-                                        nrfWeightv.push_back(nrfWeight[index]);
-                                }
-                        }
-                }
-                G4cout << G4endl << "EventCheck::EventCheck -> NRF to Optical Photon Number of Events Found: " << nrf_to_cherEvents.size() << G4endl;
+                if(!fSelCodes.empty() && std::find(fSelCodes.begin(), fSelCodes.end(), bCode) == fSelCodes.end())
+                        continue;
+
+                fHead.rank = hasSeed ? fRunRank->find(bSeed)->second : 0;
+                fHead.eventID = bEventID;
+                // without the Seed column a merged file restarts the EventIDs
+                if(lastKey.second >= 0 && GetKey() < lastKey)
+                        fUnordered = true;
+                fHead.energy = bEnergy;
+                fHead.weight = bWeight;
+                fHead.time = hasTime ? bTime : 0.;
+                ++fRowsRead;
+                return;
         }
+        fDone = true;
+}
 
-        if(num_entries2 > 0)
+G4bool EventStream::NextEvent(std::vector<EventRow>& group)
+{
+        group.clear();
+        if(fDone)
+                return false;
+        EventKey key = GetKey();
+        while(!fDone && GetKey() == key)
         {
-                for(int i=0; i<num_entries2; ++i)
-                {
-                        // Check to see if Cherenkov Event ID matches Det Event ID
-                        x = detEventv[i];
-                        auto exists = std::find(cherEventv.begin(), cherEventv.end(),x);
-                        // This section here looks at events and places the energy of the "first" aka Max energy Cherenkov photon energy in the vector cher_to_detEnergies
-                        if(exists != cherEventv.end())
-                        {
-                                index = exists - cherEventv.begin();
-                                cher_to_detEvents.push_back(x);
-                                cher_to_detEnergies.push_back(detEnergy[index]);
-                                cher_to_detWeights.push_back(detWeight[index]);
-                                cher_to_detTimes.push_back(time[index]);
-                        }
-                        // Check to see if NRF Event ID matches Det Event ID
-                        exists = std::find(nrfEventv.begin(),nrfEventv.end(),x);
-                        if(exists != nrfEventv.end())
-                        {
-                                index = exists - nrfEventv.begin();
-                                nrf_to_detEvents.push_back(x);
-                                nrf_to_detEnergies.push_back(detEnergy[index]);
-                                nrf_to_detWeights.push_back(detWeight[index]);
-                                nrf_to_detTimes.push_back(time[index]);
-                        }
-                }
+                group.push_back(fHead);
+                Advance();
+        }
+        return true;
+}
 
-                G4cout << G4endl << "EventCheck::EventCheck -> Optical Photon Events lead to Detection: " << cher_to_detEvents.size() << G4endl;
-                G4cout << "EventCheck::EventCheck -> NRF Events Lead to Detection: " << nrf_to_detEvents.size() << G4endl;
+// ******************************************************************************************************************************** //
+// Event Check
+// ******************************************************************************************************************************** //
 
-                // ******************************************************************************************************************************** //
-                // Determine if NRF and Cherenkov lead to Detection Event
-                // ******************************************************************************************************************************** //
+EventCheck::EventCheck(const G4String& fileName, const G4String& aggregation)
+        : agg(aggregation)
+{
+        time_start = std::time(&timer);
+        baseName = fileName;
+        if(baseName.find(".root") < baseName.length())
+                baseName = baseName.substr(0, baseName.find(".root"));
+        // run_*.root writes run_all_NRF_to_Cher.root
+        while(baseName.find_first_of("*?") < baseName.length())
+                baseName.replace(baseName.find_first_of("*?"), 1, "all");
 
-                // Check to see if cherenkov detected ID and nrf detected ID match
-                // Check if more cherenkov events of nrf events lead to detection if cherenkov > nrf then look at nrf->Detected events
-                if(cher_to_detEvents.size() > nrf_to_detEvents.size())
-                {
-                        //G4cout << "EventCheck::EventCheck -> More Optical Photon Events than nrf events lead to detection. Checking NRF Detected Events..." << G4endl;
-                        for(unsigned int i=0; i<nrf_to_detEvents.size(); ++i)
-                        {
-                                x = nrf_to_detEvents[i];
-                                auto exists = std::find(cher_to_detEvents.begin(), cher_to_detEvents.end(),x);
-                                if(exists != cher_to_detEvents.end())
-                                {
-                                        index = exists - cher_to_detEvents.begin();
-                                        nrf_to_cherenkov_to_detEvents.push_back(x);
-                                        nrf_to_cherenkov_to_detNRFEnergies.push_back(nrf_to_detEnergies[i]);
-                                        nrf_to_cherenkov_to_detCherEnergies.push_back(cher_to_detEnergies[index]);
-                                        nrf_to_cherenkov_to_detNRFWeights.push_back(nrf_to_detWeights[i]);
-                                        nrf_to_cherenkov_to_detCherWeights.push_back(cher_to_detWeights[index]);
-                                        nrf_to_cherenkov_to_detNRFTimes.push_back(nrf_to_detTimes[i]);
-                                        nrf_to_cherenkov_to_detCherTimes.push_back(cher_to_detTimes[index]);
-                                }
-                        }
-                }
-                else if(nrf_to_detEvents.size() > cher_to_detEvents.size())
+        if(agg != "first" && agg != "max" && agg != "sum")
+        {
+                G4cerr << "EventCheck::EventCheck -> Unknown aggregation " << agg << ". Using first." << G4endl;
+                agg = "first";
+        }
+
+        // the chain only expands the wildcards, the files are opened one at a time in WriteEvents
+        TChain chain("NRFMatData");
+        chain.Add(fileName.c_str());
+        TIter next(chain.GetListOfFiles());
+        while(TObject* element = next())
+        {
+                if(gSystem->AccessPathName(element->GetTitle()))
                 {
-                        //G4cout << "EventCheck::EventCheck -> More NRF Events than Optical Photon events lead to detection. Checking Optical Photon Events..." << G4endl;
-                        for(unsigned int i=0; i<cher_to_detEvents.size(); ++i)
-                        {
-                                x = cher_to_detEvents[i];
-                                auto exists = std::find(nrf_to_detEvents.begin(), nrf_to_detEvents.end(),x);
-                                if(exists != nrf_to_detEvents.end())
-                                {
-                                        index = exists - nrf_to_detEvents.begin();
-                                        nrf_to_cherenkov_to_detEvents.push_back(x);
-                                        nrf_to_cherenkov_to_detNRFEnergies.push_back(nrf_to_detEnergies[index]);
-                                        nrf_to_cherenkov_to_detCherEnergies.push_back(cher_to_detEnergies[i]);
-                                        nrf_to_cherenkov_to_detNRFWeights.push_back(nrf_to_detWeights[index]);
-                                        nrf_to_cherenkov_to_detCherWeights.push_back(cher_to_detWeights[i]);
-                                        nrf_to_cherenkov_to_detNRFTimes.push_back(nrf_to_detTimes[index]);
-                                        nrf_to_cherenkov_to_detCherTimes.push_back(cher_to_detTimes[i]);
-                                }
-                        }
+                        G4cerr << "EventCheck::EventCheck -> File: " << element->GetTitle() << " does not exist." << G4endl;
+                        continue;
                 }
-
-                G4cout << G4endl << "EventCheck::EventCheck -> NRF Events Leading to Optical Photons Leading to Detection: " << nrf_to_cherenkov_to_detEvents.size() << G4endl;
+                inputNames.push_back(element->GetTitle());
+        }
+        if(inputNames.empty())
+        {
+                std::cerr << "EventCheck::EventCheck -> File: " << fileName << " does not exist." << std::endl;
+                G4cerr << "EventCheck::EventCheck -> File: " << fileName << " does not exist." << G4endl;
         }
 }
+
 EventCheck::~EventCheck()
 {
 }
 
-// ******************************************************************************************************************************** //
-// Fill TTrees
-// ******************************************************************************************************************************** //
-
-void EventCheck::WriteEvents()
+EventRow EventCheck::Aggregate(const std::vector<EventRow>& group) const
 {
-        // Write to file
-        std::string FinalOutName = gOutName;
-        std::string FinalOutName2 = gOutName;
-        FinalOutName = FinalOutName + "_NRF_to_Cher.root";
-        FinalOutName2 = FinalOutName2 + "_NRF_to_Cher_to_Det.root";
-        const char* OutFilename = FinalOutName.c_str();
-        const char* OutFilename2 = FinalOutName2.c_str();
-
-        fout = new TFile(OutFilename,"recreate");
-        fout->cd();
-        
-        // Set up Output NRF to Cher Tree
-        nrf_to_cher_tree = new TTree("nrf_to_cher_tree","NRF Events that Lead to Cherenkov");
-        nrf_to_cher_tree->Branch("EventID",&nrf_cher_EventID);
-        nrf_to_cher_tree->Branch("NRF_Energy",&nrfE);
-        nrf_to_cher_tree->Branch("NRF_Weight",&nrfW);
-        nrf_to_cher_tree->Branch("Cher_Energy",&cherE);
-        nrf_to_cher_tree->Branch("Cher_Weight",&cherW);
-        
-        // Fill Tree 
-        if(num_entries > 0 && num_entries1 > 0)
+        EventRow row = group[0];
+        if(agg == "max")
         {
-                std::cout << "EventCheck::WriteEvents -> Filling NRF to Optical Photon Tree..." << std::endl;
-                G4cout << "EventCheck::WriteEvents -> Filling NRF to Optical Photon Tree..." << G4endl;
-                // Fill nrf_to_cher_tree
-                for(unsigned int i=0; i<nrf_to_cherEvents.size(); i++)
-                {
-                        nrf_cher_EventID = nrf_to_cherEvents[i];
-                        nrfE = nrfEnergyv[i];
-                        nrfW = nrfWeightv[i];
-                        cherE = cherEnergyv[i];
-                        cherW = cherWeightv[i];
-                        nrf_to_cher_tree->Fill();
-                }
+                for(unsigned int i=1; i<group.size(); ++i)
+                        if(group[i].energy > row.energy)
+                                row = group[i];
         }
+        else if(agg == "sum")
+        {
+                for(unsigned int i=1; i<group.size(); ++i)
+                        row.weight += group[i].weight;
+        }
+        return row;
+}
 
-        if(num_entries2 > 0)
+G4bool EventCheck::OrderRuns(const std::vector<std::vector<G4int> >& runs, std::map<G4int, G4int>& runRank) const
+{
+        // topological sort of the run successions of the datasets, each dataset lists its runs in file order
+        std::map<G4int, std::vector<G4int> > next;
+        std::map<G4int, G4int> nBefore;
+        for(unsigned int i=0; i<runs.size(); ++i)
         {
-                std::cout << "EventCheck::WriteEvents -> Filling NRF to Optical Photon to Detected Tree..." << std::endl;
-                G4cout << "EventCheck::WriteEvents -> Filling NRF to Optical Photon to Detected Tree..." << G4endl;
-                // Fill nrf_to_cher_to_det_tree
-                for(unsigned int i=0; i<nrf_to_cherenkov_to_detEvents.size(); i++)
+                for(unsigned int j=0; j<runs[i].size(); ++j)
                 {
-                        a = nrf_to_cherenkov_to_detEvents[i];
-                        energyNRF = nrf_to_cherenkov_to_detNRFEnergies[i];
-                        energyCher = nrf_to_cherenkov_to_detCherEnergies[i];
-                        weightNRF = nrf_to_cherenkov_to_detNRFWeights[i];
-                        weightCher = nrf_to_cherenkov_to_detCherWeights[i];
-                        timeNRF = nrf_to_cherenkov_to_detNRFTimes[i];
-                        timeCher = nrf_to_cherenkov_to_detCherTimes[i];
-                        nrf_to_cher_to_det_tree->Fill();
+                        nBefore[runs[i][j]];
+                        if(j == 0)
+                                continue;
+                        next[runs[i][j-1]].push_back(runs[i][j]);
+                        ++nBefore[runs[i][j]];
                 }
         }
-
-        // ******************************************************************************************************************************** //
-        // Write TTrees to OutFile
-        // ******************************************************************************************************************************** //
-
-        if(nrf_to_cherEvents.size() > 0)
+        std::vector<G4int> ready;
+        for(std::map<G4int, G4int>::const_iterator it = nBefore.begin(); it != nBefore.end(); ++it)
+                if(it->second == 0)
+                        ready.push_back(it->first);
+        runRank.clear();
+        while(!ready.empty())
         {
-                nrf_to_cher_tree->Write();
-                std::cout << "EventCheck::WriteEvents -> NRF to Optical Photon Events Written to file: " << OutFilename << std::endl;
-                G4cout << "EventCheck::WriteEvents -> NRF to Optical Photon Events Written to file: " << OutFilename << G4endl;
+                G4int run = ready.back();
+                ready.pop_back();
+                G4int rank = runRank.size();
+                runRank[run] = rank;
+                const std::vector<G4int>& after = next[run];
+                for(unsigned int k=0; k<after.size(); ++k)
+                        if(--nBefore[after[k]] == 0)
+                                ready.push_back(after[k]);
         }
-        else
+        if(runRank.size() != nBefore.size())
         {
-                G4cerr << OutFilename << " not written to File!" << G4endl << G4endl;
+                G4cerr << "ERROR EventCheck::OrderRuns -> The datasets list the runs in different orders." << G4endl;
+                return false;
         }
-        fout->Close();
+        return true;
+}
 
-        fout2 = new TFile(OutFilename2,"recreate");
-        fout2->cd();
-        
-        // Set up NRF to Cher to Det Tree 
-        nrf_to_cher_to_det_tree = new TTree("nrf_to_cher_to_det_tree","NRF Events that Lead to Cherenkov that were Detected");
+G4bool EventCheck::WriteEvents()
+{
+        if(inputNames.empty())
+                return false;
+
+        std::string OutFilename = baseName + "_NRF_to_Cher.root";
+        std::string OutFilename2 = baseName + "_NRF_to_Cher_to_Det.root";
+
+        G4int nrf_cher_EventID, a;
+        G4double nrfE, nrfW, cherE, cherW, energyNRF, energyCher, weightNRF, weightCher, timeNRF, timeCher;
+
+        // the output trees are filled while joining and flushed to their files as they grow
+        TFile *fout = new TFile(OutFilename.c_str(),"recreate");
+        TTree *nrf_to_cher_tree = new TTree("nrf_to_cher_tree","NRF Events that Lead to Cherenkov");
+        nrf_to_cher_tree->Branch("EventID",&nrf_cher_EventID);
+        nrf_to_cher_tree->Branch("NRF_Energy",&nrfE);
+        nrf_to_cher_tree->Branch("NRF_Weight",&nrfW);
+        nrf_to_cher_tree->Branch("Cher_Energy",&cherE);
+        nrf_to_cher_tree->Branch("Cher_Weight",&cherW);
+
+        TFile *fout2 = new TFile(OutFilename2.c_str(),"recreate");
+        TTree *nrf_to_cher_to_det_tree = new TTree("nrf_to_cher_to_det_tree","NRF Events that Lead to Cherenkov that were Detected");
         nrf_to_cher_to_det_tree->Branch("EventID",&a);
         nrf_to_cher_to_det_tree->Branch("EnergyNRF",&energyNRF);
         nrf_to_cher_to_det_tree->Branch("EnergyCher",&energyCher);
@@ -328,18 +341,128 @@ void EventCheck::WriteEvents()
         nrf_to_cher_to_det_tree->Branch("TimeNRF",&timeNRF);
         nrf_to_cher_to_det_tree->Branch("TimeCher",&timeCher);
 
-        // Fill Tree 
-        if(nrf_to_cherenkov_to_detEvents.size() > 0)
+        G4cout << "EventCheck::WriteEvents -> Joining NRF, Optical Photon and Detected Events of " << inputNames.size()
+               << " file(s) with " << agg << " aggregation..." << G4endl;
+        G4bool joined = true;
+        G4long nrfRows = 0, cherRows = 0, detRows = 0;
+        std::vector<EventRow> nrfGroup, cherGroup, detGroup;
+        for(unsigned int iFile=0; iFile<inputNames.size() && joined; ++iFile)
         {
-                nrf_to_cher_to_det_tree->Write();
-                G4cout << "NRF to Optical Photon to Detected Events Written to file: " << OutFilename2 << G4endl;
+                TFile* f = TFile::Open(inputNames[iFile].c_str());
+                if(!f || f->IsZombie())
+                {
+                        G4cerr << "ERROR EventCheck::WriteEvents -> Could not read " << inputNames[iFile] << G4endl;
+                        joined = false;
+                        break;
+                }
+                // the streams read f and are done before it is closed
+                {
+                        G4int scintCode = OutputCodes::LookUp(f, "CreatorProcessCodes", "Scintillation");
+                        G4int cherCode = OutputCodes::LookUp(f, "CreatorProcessCodes", "Cerenkov");
+                        EventStream nrf(f, "NRFMatData", "Time");
+                        EventStream cher(f, "Cherenkov", "Time");
+                        EventStream det(f, "DetInfo", "Time", "CreatorProcess", {scintCode, cherCode});
+
+                        // a dataset can miss runs without rows, the runs are ranked consistently with all three
+                        std::vector<std::vector<G4int> > runs(3);
+                        std::map<G4int, G4int> runRank;
+                        joined = nrf.ScanRuns(runs[0]) && cher.ScanRuns(runs[1]) && det.ScanRuns(runs[2]) && OrderRuns(runs, runRank);
+                        if(joined)
+                        {
+                                nrf.Start(runRank);
+                                cher.Start(runRank);
+                                det.Start(runRank);
+                        }
+
+                        while(joined && !nrf.Done() && !cher.Done() && !nrf.IsUnordered() && !cher.IsUnordered() && !det.IsUnordered())
+                        {
+                                // skip the events of the stream that is behind
+                                if(nrf.GetKey() < cher.GetKey())
+                                {
+                                        nrf.NextEvent(nrfGroup);
+                                        continue;
+                                }
+                                if(cher.GetKey() < nrf.GetKey())
+                                {
+                                        cher.NextEvent(cherGroup);
+                                        continue;
+                                }
+
+                                EventKey key = nrf.GetKey();
+                                nrf.NextEvent(nrfGroup);
+                                cher.NextEvent(cherGroup);
+                                EventRow nrfRow = Aggregate(nrfGroup);
+                                EventRow cherRow = Aggregate(cherGroup);
+
+                                nrf_cher_EventID = key.second;
+                                nrfE = nrfRow.energy;
+                                nrfW = nrfRow.weight;
+                                cherE = cherRow.energy;
+                                cherW = cherRow.weight;
+                                nrf_to_cher_tree->Fill();
+
+                                while(!det.Done() && det.GetKey() < key)
+                                        det.NextEvent(detGroup);
+                                if(!det.Done() && det.GetKey() == key)
+                                {
+                                        det.NextEvent(detGroup);
+                                        EventRow detRow = Aggregate(detGroup);
+                                        a = key.second;
+                                        energyNRF = nrfRow.energy;
+                                        energyCher = cherRow.energy;
+                                        weightNRF = nrfRow.weight;
+                                        weightCher = cherRow.weight;
+                                        timeNRF = nrfRow.time;
+                                        timeCher = detRow.time;
+                                        nrf_to_cher_to_det_tree->Fill();
+                                }
+                        }
+
+                        if(nrf.IsUnordered() || cher.IsUnordered() || det.IsUnordered())
+                                joined = false;
+                        if(!joined)
+                                G4cerr << "ERROR EventCheck::WriteEvents -> The runs of " << inputNames[iFile] << " cannot be told apart,"
+                                       << " it was merged from files written before the Seed column or from runs with the same seed."
+                                       << " Join the unmerged output files instead (-j \"run_*.root\")." << G4endl;
+                        nrfRows += nrf.GetRowsRead();
+                        cherRows += cher.GetRowsRead();
+                        detRows += det.GetRowsRead();
+                }
+                f->Close();
+                delete f;
         }
-        else
+
+        // a partial join is never written
+        if(!joined)
         {
-                G4cout << OutFilename2 << " not written to File!" << G4endl << G4endl;
+                fout->Close();
+                fout2->Close();
+                gSystem->Unlink(OutFilename.c_str());
+                gSystem->Unlink(OutFilename2.c_str());
+                G4cerr << "ERROR EventCheck::WriteEvents -> No output written." << G4endl;
+                return false;
         }
 
+        G4cout << "EventCheck::WriteEvents -> NRF Entries: " << nrfRows << " Cherenkov Entries: " << cherRows
+               << " Detected Optical Photon Entries: " << detRows << G4endl;
+        G4cout << "EventCheck::WriteEvents -> NRF to Optical Photon Number of Events Found: " << nrf_to_cher_tree->GetEntries() << G4endl;
+        G4cout << "EventCheck::WriteEvents -> NRF Events Leading to Optical Photons Leading to Detection: " << nrf_to_cher_to_det_tree->GetEntries() << G4endl;
+
+        // ******************************************************************************************************************************** //
+        // Write TTrees to OutFile
+        // ******************************************************************************************************************************** //
+
+        fout->cd();
+        nrf_to_cher_tree->Write();
+        fout->Close();
+        G4cout << "EventCheck::WriteEvents -> NRF to Optical Photon Events Written to file: " << OutFilename << G4endl;
+
+        fout2->cd();
+        nrf_to_cher_to_det_tree->Write();
         fout2->Close();
+        G4cout << "EventCheck::WriteEvents -> NRF to Optical Photon to Detected Events Written to file: " << OutFilename2 << G4endl;
+
         time_end = std::time(&timer2);
-        G4cout << "Event Check took: " << std::difftime(time_end, time_start) << " seconds!" << G4endl << G4endl;
+        G4cout << "EventCheck::WriteEvents -> Event Check took: " << std::difftime(time_end, time_start) << " seconds!" << G4endl;
+        return true;
 }
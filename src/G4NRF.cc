@@ -151,6 +151,10 @@ using std::pow;
 
 const bool interrupt = false;
 
+G4int G4NRF::nSplit = 1;
+G4double G4NRF::splitAngle = 120.0*deg;
+G4double G4NRF::splitHalfWidth = 30.0*deg;
+
 G4NRF::G4NRF(const G4String& processName, G4bool Verbose_in, G4bool use_xsec_tables_in,
              G4bool use_xsec_integration_in, G4bool force_isotropic_in, G4bool standalone_in)
         : G4VDiscreteProcess(processName),
@@ -422,6 +426,10 @@ G4VParticleChange* G4NRF::PostStepDoIt(const G4Track& trackData,
         G4bool first_pass = true;
         G4double energy_deposit = 0.0;
 
+        // the secondaries carry their own weights when they are split
+        const G4double parentWeight = trackData.GetWeight();
+        aParticleChange.SetSecondaryWeightByProcess(true);
+
         pNuclearLevelManager = G4NRFNuclearLevelStore::GetInstance()->GetManager(Z_excited, A_excited);
 
         if (pNuclearLevelManager) {
@@ -467,29 +475,43 @@ G4VParticleChange* G4NRF::PostStepDoIt(const G4Track& trackData,
                                 gamma_emission = !ForbiddenTransition(pLevel, pLevel_next);
 
                         if (gamma_emission) { // i.e. gamma emission, not conversion electron
-                                if (first_pass) {
-                                        G4double J0, J, Jf; // Spin of initial, intermediate, & final levels
-                                        G4int L1, L2; // Angular momentum of excitation, de-excitation gammas
-                                        G4double Delta1, Delta2; // mixing ratios for excitation, de-excitation
-
-                                        if (!force_isotropic_ang_corr) {
-                                                SetupMultipolarityInfo(nLevel, E_gamma, jgamma, pLevel, pLevel_next, J0, J, Jf, L1, L2, Delta1, Delta2);
-
-                                                emitted_gamma_direction = SampleCorrelation(J0, J, Jf, L1, L2, Delta1, Delta2);
+                                G4double J0, J, Jf; // Spin of initial, intermediate, & final levels
+                                G4int L1, L2; // Angular momentum of excitation, de-excitation gammas
+                                G4double Delta1, Delta2; // mixing ratios for excitation, de-excitation
+
+                                // angular correlations not included after first pass (i.e., after first (gamma, gamma) pair)
+                                // or if the user has chosen to disable them
+                                G4bool correlated = first_pass && !force_isotropic_ang_corr;
+                                if (correlated)
+                                        SetupMultipolarityInfo(nLevel, E_gamma, jgamma, pLevel, pLevel_next, J0, J, Jf, L1, L2, Delta1, Delta2);
+
+                                // without splitting (nSplit = 1) this is the analog emission of one gamma
+                                for (G4int isplit = 0; isplit < nSplit; ++isplit) {
+                                        if (correlated) {
+                                                if (isplit == 0)
+                                                        emitted_gamma_direction = SampleCorrelation(J0, J, Jf, L1, L2, Delta1, Delta2);
+                                                else if (pAngular_Correlation->ValidParameters())
+                                                        emitted_gamma_direction = SampleCorrelatedDirection();
+                                                else
+                                                        emitted_gamma_direction = SampleIsotropic();
 
                                                 emitted_gamma_direction.rotateUz(IncidentGammaDirection);
-                                        } else { // User has chosen to disable angular correlations
+                                        } else {
                                                 emitted_gamma_direction = SampleIsotropic();
                                         }
-                                } else { // angular correlations not included after first pass (i.e., after first (gamma, gamma) pair)
-                                        emitted_gamma_direction = SampleIsotropic();
-                                }
 
-                                // Create G4DynamicParticle object for the emitted gamma and add it to the tracking stack.
-                                // IMPORTANT NOTE: this currently produces _monoenergetic_ photons with energy E_gamma, rather
-                                // than the incident energy minus the recoil!
-                                G4DynamicParticle* aGamma = new G4DynamicParticle(G4Gamma::Gamma(), emitted_gamma_direction, E_gamma);
-                                aParticleChange.AddSecondary(aGamma);
+                                        G4double weight = parentWeight/nSplit;
+                                        if (nSplit > 1 && !InSplittingWindow(emitted_gamma_direction)) {
+                                                // Russian roulette away from the detectors, one in nSplit copies survives with the parent weight
+                                                if (G4UniformRand()*nSplit >= 1.0)
+                                                        continue;
+                                                weight = parentWeight;
+                                        }
+
+                                        // IMPORTANT NOTE: this currently produces _monoenergetic_ photons with energy E_gamma, rather
+                                        // than the incident energy minus the recoil!
+                                        AddGamma(trackData, emitted_gamma_direction, E_gamma, weight);
+                                }
                         } // gamma emission? (i.e. E_gamma > 0?)
 
 
@@ -791,24 +813,51 @@ G4ThreeVector G4NRF::SampleCorrelation(const G4double Ji, const G4double J,  con
 
 
         if (correlation_info_available) {
-                G4double y_rnd = G4UniformRand();
+                return SampleCorrelatedDirection();
+        } else { // angular momenta aren't in Angular_Correlation coefficient tables -- bail out with isotropic emission direction
+                return SampleIsotropic();
+        }
+}
 
-                G4double cos_theta = pAngular_Correlation->Sample(y_rnd);
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// ****************************************************************************************************
+G4ThreeVector G4NRF::SampleCorrelatedDirection() {
+        G4double y_rnd = G4UniformRand();
 
-                G4double theta     = acos(cos_theta);
-                G4double sin_theta = sin(theta);
-                G4double phi       = 2.0*pi*G4UniformRand();
+        G4double cos_theta = pAngular_Correlation->Sample(y_rnd);
 
-                G4double cos_x = sin_theta*cos(phi);
-                G4double cos_y = sin_theta*sin(phi);
-                G4double cos_z = cos_theta;
+        G4double theta     = acos(cos_theta);
+        G4double sin_theta = sin(theta);
+        G4double phi       = 2.0*pi*G4UniformRand();
 
-                G4ThreeVector new_direc(cos_x, cos_y, cos_z);
+        G4double cos_x = sin_theta*cos(phi);
+        G4double cos_y = sin_theta*sin(phi);
+        G4double cos_z = cos_theta;
 
-                return new_direc;
-        } else { // angular momenta aren't in Angular_Correlation coefficient tables -- bail out with isotropic emission direction
-                return SampleIsotropic();
-        }
+        G4ThreeVector new_direc(cos_x, cos_y, cos_z);
+
+        return new_direc;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// ****************************************************************************************************
+G4bool G4NRF::InSplittingWindow(const G4ThreeVector& direction) const {
+        // the water tanks sit on both sides of the beam axis (+x and -x) at splitAngle from the beam direction
+        const G4ThreeVector tank(sin(splitAngle), 0.0, cos(splitAngle));
+        const G4ThreeVector tank2(-sin(splitAngle), 0.0, cos(splitAngle));
+
+        return direction.angle(tank) < splitHalfWidth || direction.angle(tank2) < splitHalfWidth;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+// ****************************************************************************************************
+void G4NRF::AddGamma(const G4Track& trackData, const G4ThreeVector& direction, G4double E_gamma, G4double weight) {
+        // Create G4DynamicParticle object for the emitted gamma and add it to the tracking stack.
+        G4DynamicParticle* aGamma = new G4DynamicParticle(G4Gamma::Gamma(), direction, E_gamma);
+        G4Track* aTrack = new G4Track(aGamma, trackData.GetGlobalTime(), trackData.GetPosition());
+        aTrack->SetTouchableHandle(trackData.GetTouchableHandle());
+        aTrack->SetWeight(weight);
+        aParticleChange.AddSecondary(aTrack);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
@@ -23,24 +23,47 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "HistoManager.hh"
+#include "HistoMessenger.hh"
+#include "HistoNames.hh"
+#include <algorithm>
 
 extern G4String gOutName;
+extern G4String root_output_name;
 extern G4String inFile;
 extern G4double chosen_energy;
 extern G4bool bremTest;
+extern G4bool resume;
+extern G4bool checkEvents;
+extern G4long seed;
 
-HistoManager::HistoManager() : fFactoryOn(false)
+HistoManager::HistoManager() : fFactoryOn(false), xmax(0.), hBrems(0), binning("uniform"),
+        binWidth(1.*keV), fineBinWidth(5.*eV), resonanceWindow(50.*eV),
+        format("TTree"), compression("zstd"), compressionLevel(5), clusterSize(50.), useRNTuple(false),
+        async(false), queueSize(65536), fQueue(NULL), fWriterRunning(false), fManager(NULL),
+        checkpointEvents(0), analysisThreads(0), checkpointSeconds(0.), useParts(false), fComplete(false), fPart(0), fEventsDone(0), fEventsAtCheckpoint(0),
+        fTotalEvents(0), fEventOffset(0), fLastCheckpoint(0), histoM(NULL)
 {
+        histoM = new HistoMessenger(this);
+#ifdef MANTIS_RNTUPLE
+        fRNTuple = NULL;
+#endif
 }
 
 HistoManager::~HistoManager()
 {
+        StopWriter();
+        delete histoM;
+#ifdef MANTIS_RNTUPLE
+        delete fRNTuple;
+#endif
 }
 
 void HistoManager::Book()
 {
         G4AnalysisManager* manager = G4AnalysisManager::Instance(); 
         manager->SetVerboseLevel(0);
+        // the instance is thread local, the writer thread fills through this pointer
+        fManager = manager;
         xmax = chosen_energy;
         
         if(!bremTest && chosen_energy < 0)
@@ -62,6 +85,26 @@ void HistoManager::Book()
                         {
                                 xmax = hBrems->GetXaxis()->GetXmax();
                                 G4cout << "Found Input Max Energy: " << xmax << " MeV" << G4endl;
+                                // Find the resonance windows of the importance sampling distribution
+                                resonances.clear();
+                                TH1D *hSample = 0;
+                                fin->GetObject("hSample", hSample);
+                                if(binning == "resonance" && hSample)
+                                {
+                                        G4double threshold = 0.5*hSample->GetMaximum();
+                                        G4int nb = hSample->GetNbinsX();
+                                        for(G4int i=1; i<=nb; ++i)
+                                        {
+                                                if(hSample->GetBinContent(i) <= threshold)
+                                                        continue;
+                                                G4int j = i;
+                                                while(j < nb && hSample->GetBinContent(j+1) > threshold)
+                                                        ++j;
+                                                resonances.push_back(0.5*(hSample->GetXaxis()->GetBinLowEdge(i) + hSample->GetXaxis()->GetBinUpEdge(j)));
+                                                i = j;
+                                        }
+                                        G4cout << "HistoManager::Book -> Found " << resonances.size() << " resonances in hSample." << G4endl;
+                                }
                                 fin->Close();
                         } // for if !hBrems            
                 } // for if gSystem
@@ -72,18 +115,133 @@ void HistoManager::Book()
                 } // for if !gSystem 
         } // for if not bremTest and chosen_energy < 0
 
-        // open output file
-        G4bool fileOpen = manager->OpenFile(gOutName);
-        
-        //std::cout << "Energy for xMax: " << xmax << std::endl;
-        
+        // open output file. With the RNTuple backend the output file holds the RNTuples
+        // and the histograms are copied in from a temporary file at the end of the run
+        useRNTuple = (format == "RNTuple");
+#ifndef MANTIS_RNTUPLE
+        if(useRNTuple)
+        {
+                G4cerr << "ERROR HistoManager::Book: mantis was built without RNTuple support. Using TTree output." << G4endl;
+                useRNTuple = false;
+        }
+#endif
+
+        // with checkpointing the run is written in parts which are merged at the end of the run
+        useParts = (checkpointEvents > 0 || checkpointSeconds > 0 || resume);
+        // a run that asked for checkpoints must not run without them, a resumed run would start over
+        if(useParts && useRNTuple)
+        {
+                G4cerr << "FATAL ERROR HistoManager::Book: Checkpointing and --resume require /output/format TTree." << G4endl;
+                exit(1);
+        }
+        // without a checkpoint interval a killed run leaves nothing to resume from
+        if(resume && checkpointEvents <= 0 && checkpointSeconds <= 0)
+        {
+                G4cerr << "FATAL ERROR HistoManager::Book: --resume requires /output/checkpointEvents or /output/checkpointSeconds." << G4endl;
+                exit(1);
+        }
+        fPart = 0;
+        fEventsDone = 0;
+        fComplete = false;
+        fTotalEvents = G4RunManager::GetRunManager()->GetCurrentRun()->GetNumberOfEventToBeProcessed();
+        if(useParts && resume)
+                ReadCheckpoint();
+        else if(useParts)
+                gSystem->Unlink((gOutName + ".checkpoint").c_str());
+
+        // the checkpoint of a finished run marks its output as complete, the output is not recreated
+        if(useParts && resume && fTotalEvents > 0 && fEventsDone >= fTotalEvents)
+        {
+                G4cout << "HistoManager::Book -> " << gOutName << ".root is complete. Skipping the run." << G4endl;
+                fComplete = true;
+                G4RunManager::GetRunManager()->AbortRun(true);
+                return;
+        }
+        fEventOffset = fEventsDone;
+        fEventsAtCheckpoint = fEventsDone;
+        fLastCheckpoint = time(0);
+
+        G4String histoFileName = useRNTuple ? gOutName + "_histos" : gOutName;
+        if(useParts)
+                histoFileName = PartName(fPart);
+        G4bool fileOpen = manager->OpenFile(histoFileName);
+
         if(!fileOpen)
         {
                 G4cerr << "HistoManager::Book(): Cannot Open " <<manager->GetFileName()<<G4endl;
                 return;
         }
 
-        G4int nbins = xmax/(10.0e-6/2.0);
+        if(binning == "resonance" && resonances.empty())
+                G4cout << "HistoManager::Book -> No hSample resonances found. Using uniform binning." << G4endl;
+        BuildEdges();
+        for(unsigned int i=0; i<sparseHistos.size(); ++i)
+                delete sparseHistos[i];
+        sparseHistos.clear();
+
+        if(useRNTuple)
+        {
+#ifdef MANTIS_RNTUPLE
+                fRNTuple = new RNTupleOutput(gOutName + ".root", GetCompressionSettings(), clusterSize);
+#endif
+        }
+        else
+        {
+                manager->SetCompressionLevel(compressionLevel);
+                CreateNtuples();
+        }
+
+        // Create ID 0 1D Histogram for Weighted Chopper Incident Data
+        CreateH1(HistoNames::kH1[0], "Weighted Incident Chopper Energy Spectrum", 0., xmax, "MeV");
+        // Create ID 1 1D Histogram for Weighted Chopper Exiting Data
+        CreateH1(HistoNames::kH1[1], "Weighted Emission Chopper Energy Spectrum", 0., xmax, "MeV");
+
+        if(!bremTest)
+        {
+                // Create ID 2,3,4,5 1D Histogram for Interogation Object Data
+                CreateH1(HistoNames::kH1[2], "Interrogation Object Incident Weighted Energy Spectrum", 0., xmax, "MeV");
+                CreateH1(HistoNames::kH1[3], "Interrogation Object NRF Photons Incident Weighted Energy Spectrum", 0., xmax, "MeV");
+                CreateH1(HistoNames::kH1[4], "Interrogation Object Exiting Weighted Energy Spectrum", 0., xmax, "MeV");
+                CreateH1(HistoNames::kH1[5], "Interrogation Object NRF Photons Exiting Weighted Energy Spectrum", 0., xmax, "MeV");
+                // Create ID 6,7 1D Histogram for incident water data
+                CreateH1(HistoNames::kH1[6], "Water Tank Incident Weighted Energy Spectrum", 0., xmax, "MeV");
+                CreateH1(HistoNames::kH1[7], "Water Tank NRF Photons Incident Weighted Energy Spectrum", 0., xmax, "MeV");
+                // Create Histogram ID 8
+                CreateH1(HistoNames::kH1[8], "NRF Weighted Energy Spectrum", 0., xmax, "MeV");
+                // Create Histogram ID 9
+                CreateH1(HistoNames::kH1[9], "Cherenkov Weighted Energy Spectrum", 0., xmax, "MeV");
+                // Create ID 10 Histogram for Incident Detector
+                CreateH1(HistoNames::kH1[10], "Incident Detector Weighted Energy Spectrum", 0., xmax, "MeV");
+                // Create ID 11 Histogram for Energy if detected
+                CreateH1(HistoNames::kH1[11], "Photons Detected by Photocathode Weighted Energy Spectrum", 0., 100., "eV");
+        }
+
+        if(async)
+                StartWriter();
+
+        fFactoryOn = true;
+        //std::cout << "HistoManager::Book() --> Complete!" << std::endl;
+
+}
+
+void HistoManager::SetOutputName(G4String name)
+{
+        if(fFactoryOn)
+        {
+                G4cerr << "ERROR HistoManager::SetOutputName: " << gOutName << ".root is still open. Output name not changed." << G4endl;
+                return;
+        }
+        root_output_name = name;
+        std::string outName = (std::string)name;
+        if(outName.find(".root") < outName.length())
+                gOutName = (std::string)outName.substr(0, outName.find(".root"));
+        else
+                gOutName = name;
+}
+
+void HistoManager::CreateNtuples()
+{
+        G4AnalysisManager* manager = G4AnalysisManager::Instance();
         // Create ID 0 Ntuple for Incident Chopper Data
         manager->CreateNtuple("ChopIn", "Chopper Wheel Incident Data");
         manager->CreateNtupleDColumn("Energy");
@@ -98,98 +256,587 @@ void HistoManager::Book()
         manager->CreateNtupleIColumn("isNRF");
         manager->FinishNtuple();
 
-        // Create ID 0 1D Histogram for Weighted Chopper Incident Data
-        manager->CreateH1("ChopperIn_Weighted","Weighted Incident Chopper Energy Spectrum", nbins, 0., xmax, "MeV");
-        // Create ID 1 1D Histogram for Weighted Chopper Exiting Data
-        manager->CreateH1("ChopperOut_Weighted", "Weighted Emission Chopper Energy Spectrum", nbins, 0., xmax, "MeV");
-
-        if(!bremTest)
-        {
-                // Create ID 2,3,4,5 1D Histogram for Interogation Object Data
-                manager->CreateH1("IntObjIn","Interrogation Object Incident Weighted Energy Spectrum", nbins, 0., xmax, "MeV");
-                manager->CreateH1("NRFIntObjIn", "Interrogation Object NRF Photons Incident Weighted Energy Spectrum",nbins,0.,xmax, "MeV");
-                manager->CreateH1("IntObjOut", "Interrogation Object Exiting Weighted Energy Spectrum", nbins, 0., xmax, "MeV");
-                manager->CreateH1("NRFIntObjOut", "Interrogation Object NRF Photons Exiting Weighted Energy Spectrum", nbins, 0., xmax, "MeV");
-                // Create ID 6,7 1D Histogram for incident water data
-                manager->CreateH1("WaterIn", "Water Tank Incident Weighted Energy Spectrum", nbins,0., xmax, "MeV");
-                manager->CreateH1("NRFWaterIn","Water Tank NRF Photons Incident Weighted Energy Spectrum", nbins, 0., xmax, "MeV");
-
-                // Create ID 2 Ntuple for NRF Materials
-                manager->CreateNtuple("NRFMatData","NRF Material vs Energy");
-                manager->CreateNtupleIColumn("EventID");
-                manager->CreateNtupleDColumn("Energy");
-                manager->CreateNtupleDColumn("Weight");
-                manager->CreateNtupleSColumn("Material");
-                manager->CreateNtupleDColumn("ZPos");
-                manager->FinishNtuple();
+        if(bremTest)
+                return;
 
-                // Create Histogram ID 8
-                manager->CreateH1("NRF_Weighted","NRF Weighted Energy Spectrum", nbins, 0., xmax, "MeV");
+        // Create ID 2 Ntuple for NRF Materials
+        manager->CreateNtuple("NRFMatData","NRF Material vs Energy");
+        manager->CreateNtupleIColumn("EventID");
+        manager->CreateNtupleDColumn("Energy");
+        manager->CreateNtupleDColumn("Weight");
+        manager->CreateNtupleIColumn("Material"); // see MaterialCodes
+        manager->CreateNtupleDColumn("ZPos");
+        manager->CreateNtupleDColumn("Time");
+        manager->CreateNtupleIColumn("Seed"); // run key, EventCheck joins merged files on Seed and EventID
+        manager->FinishNtuple();
 
-                // Create ID 3 Ntuple for cherenkov in water
-                manager->CreateNtuple("Cherenkov","Cherenkov in Water Data");
-                manager->CreateNtupleDColumn("Energy");
-                manager->CreateNtupleDColumn("Weight");
-                manager->CreateNtupleIColumn("EventID");
-                manager->CreateNtupleIColumn("NumSecondaries");
-                manager->CreateNtupleDColumn("Time");
-                manager->FinishNtuple();
+        // Create ID 3 Ntuple for cherenkov in water
+        manager->CreateNtuple("Cherenkov","Cherenkov in Water Data");
+        manager->CreateNtupleDColumn("Energy");
+        manager->CreateNtupleDColumn("Weight");
+        manager->CreateNtupleIColumn("EventID");
+        manager->CreateNtupleIColumn("NumSecondaries");
+        manager->CreateNtupleDColumn("Time"); // mean time of the Cherenkov steps
+        manager->CreateNtupleDColumn("TimeMin");
+        manager->CreateNtupleDColumn("TimeRMS");
+        manager->CreateNtupleIColumn("Seed");
+        manager->FinishNtuple();
 
-                // Create Histogram ID 9
-                manager->CreateH1("Cherenkov_Weighted", "Cherenkov Weighted Energy Spectrum", nbins,0.,xmax,"MeV");
-
-                // Create ID 4 Ntuple for Detected Information
-                manager->CreateNtuple("DetInfo","Detected Information");
-                manager->CreateNtupleIColumn("EventID");
-                manager->CreateNtupleDColumn("Energy");
-                manager->CreateNtupleDColumn("Weight");
-                manager->CreateNtupleSColumn("CreatorProcess");
-                manager->CreateNtupleDColumn("Time");
-                manager->FinishNtuple();
-
-                // Create ID 5 Ntuple for Detector Process Information
-                manager->CreateNtuple("IncDetInfo","Incident Detector Process Information");
-                manager->CreateNtupleIColumn("EventID");
-                manager->CreateNtupleDColumn("Energy");
-                manager->CreateNtupleDColumn("Weight");
-                manager->CreateNtupleSColumn("DetProcess");
-                manager->FinishNtuple();
-                
-                // Create ID 6 NTuple for Incident Interrogation Object Information
-                // Added on later as a test 
-                //manager->CreateNtuple("IncIntObjInfo","Incident Interrogation Object Information");
-                //manager->CreateNtupleDColumn("Energy");
-                //manager->CreateNtupleDColumn("Weight");
-                //manager->CreateNtupleSColumn("CreatorProcess");
-                //manager->CreateNtupleDColumn("Z_Position");
-                //manager->CreateNtupleDColumn("Cos_theta");
-                //manager->CreateNtupleDColumn("Time");
-                //manager->FinishNtuple();
+        // Create ID 4 Ntuple for Detected Information
+        manager->CreateNtuple("DetInfo","Detected Information");
+        manager->CreateNtupleIColumn("EventID");
+        manager->CreateNtupleDColumn("Energy");
+        manager->CreateNtupleDColumn("Weight");
+        manager->CreateNtupleIColumn("CreatorProcess"); // see CreatorProcessCodes
+        manager->CreateNtupleDColumn("Time");
+        manager->CreateNtupleIColumn("Seed");
+        manager->FinishNtuple();
 
-                // Create ID 10 Histogram for Incident Detector
-                manager->CreateH1("Inc_Det_Weighted", "Incident Detector Weighted Energy Spectrum", nbins, 0., xmax, "MeV");
+        // Create ID 5 Ntuple for Detector Process Information
+        manager->CreateNtuple("IncDetInfo","Incident Detector Process Information");
+        manager->CreateNtupleIColumn("EventID");
+        manager->CreateNtupleDColumn("Energy");
+        manager->CreateNtupleDColumn("Weight");
+        manager->CreateNtupleIColumn("DetProcess"); // see DetProcessCodes
+        manager->FinishNtuple();
 
-                // Create ID 11 Histogram for Energy if detected
-                manager->CreateH1("Detected_Weighted","Photons Detected by Photocathode Weighted Energy Spectrum", nbins, 0., 100., "eV");
+        if(!checkEvents)
+                return;
 
-        }
+        // Create ID 6 Ntuple for NRF events that lead to optical photons, filled by EventAction
+        manager->CreateNtuple("nrf_to_cher_tree","NRF Events that Lead to Cherenkov");
+        manager->CreateNtupleIColumn("EventID");
+        manager->CreateNtupleDColumn("NRF_Energy");
+        manager->CreateNtupleDColumn("NRF_Weight");
+        manager->CreateNtupleDColumn("Cher_Energy"); // max optical photon parent energy
+        manager->CreateNtupleDColumn("Cher_Weight");
+        manager->FinishNtuple();
 
-        fFactoryOn = true;
-        //std::cout << "HistoManager::Book() --> Complete!" << std::endl;
+        // Create ID 7 Ntuple for NRF events that lead to optical photons that were detected
+        manager->CreateNtuple("nrf_to_cher_to_det_tree","NRF Events that Lead to Cherenkov that were Detected");
+        manager->CreateNtupleIColumn("EventID");
+        manager->CreateNtupleDColumn("EnergyNRF");
+        manager->CreateNtupleDColumn("EnergyCher");
+        manager->CreateNtupleDColumn("WeightNRF");
+        manager->CreateNtupleDColumn("WeightCher");
+        manager->CreateNtupleDColumn("TimeNRF"); // first NRF of the event
+        manager->CreateNtupleDColumn("TimeCher"); // first detection of the event
+        manager->FinishNtuple();
+}
 
+G4int HistoManager::GetCompressionSettings() const
+{
+        // ROOT compression settings are algorithm*100 + level
+        if(compression == "none")
+                return 0;
+        else if(compression == "zlib")
+                return 100 + compressionLevel;
+        else if(compression == "lz4")
+                return 400 + compressionLevel;
+        else
+                return 500 + compressionLevel; // zstd
 }
 
 void HistoManager::finish()
 {
+        if(fComplete)
+                return;
         if(!fFactoryOn) {
                 G4cout << "ERROR HistoManager::finish: Failed to write to file" << G4endl;
                 return;
         }
+        // all queued records have to be written before the file is closed
+        StopWriter();
         G4AnalysisManager* manager = G4AnalysisManager::Instance();
-        manager->Write();
-        manager->CloseFile();
+        G4String fileName = gOutName + ".root";
+        if(useParts)
+        {
+                WritePart();
+                WriteCheckpoint();
+                MergeParts();
+        }
+        else
+        {
+                manager->Write();
+                manager->CloseFile();
+        }
+#ifdef MANTIS_RNTUPLE
+        if(fRNTuple)
+        {
+                // committing the RNTuples closes the output file
+                delete fRNTuple;
+                fRNTuple = NULL;
+        }
+#endif
+
+        // Write the code -> name dictionaries for the integer coded columns and any sparse histograms
+        TFile *fout = TFile::Open(fileName.c_str(), "UPDATE");
+        if(fout && !fout->IsZombie())
+        {
+                if(useRNTuple)
+                {
+                        // move the histograms from the temporary file into the output file
+                        G4String histoFileName = gOutName + "_histos.root";
+                        TFile *fhisto = TFile::Open(histoFileName.c_str());
+                        if(fhisto && !fhisto->IsZombie())
+                        {
+                                TIter next(fhisto->GetListOfKeys());
+                                TKey *key;
+                                while((key = (TKey*)next()))
+                                {
+                                        TObject *obj = key->ReadObj();
+                                        fout->cd();
+                                        obj->Write(key->GetName());
+                                        delete obj;
+                                }
+                                fhisto->Close();
+                                gSystem->Unlink(histoFileName.c_str());
+                        }
+                        else
+                                G4cerr << "ERROR HistoManager::finish: Could not read histograms from " << histoFileName << G4endl;
+                }
+                OutputCodes::Write(fout);
+                // with checkpointing the sparse histograms were merged from the parts
+                for(unsigned int i=0; i<sparseHistos.size() && !useParts; ++i)
+                        sparseHistos[i]->Write();
+                fout->Close();
+        }
+        else
+                G4cerr << "ERROR HistoManager::finish: Could not write code dictionaries to " << fileName << G4endl;
+
         std::cout << "HistoManager::finish -> Ntuples are saved." << std::endl;
         G4cout << "HistoManager::finish -> Ntuples are saved. " << G4endl;
         delete manager;
+        for(unsigned int i=0; i<sparseHistos.size(); ++i)
+                delete sparseHistos[i];
+        sparseHistos.clear();
         fFactoryOn = false;
 }
+
+// ******************************************************************************************************************************** //
+// Ntuple and Histogram Fills
+// ******************************************************************************************************************************** //
+
+void HistoManager::FillH1(G4int id, G4double x, G4double w)
+{
+        OutputRecord rec = {kH1Record, id, 0, x, w, 0.};
+        Dispatch(rec);
+}
+
+void HistoManager::FillChopIn(G4int eventID, G4double energy, G4double weight)
+{
+        OutputRecord rec = {kChopInRecord, eventID, 0, energy, weight, 0.};
+        Dispatch(rec);
+}
+
+void HistoManager::FillChopOut(G4int eventID, G4double energy, G4double weight, G4int isNRF)
+{
+        OutputRecord rec = {kChopOutRecord, eventID, isNRF, energy, weight, 0.};
+        Dispatch(rec);
+}
+
+void HistoManager::FillNRF(G4int eventID, G4double energy, G4double weight, G4int material, G4double zPos, G4double time)
+{
+        OutputRecord rec = {kNRFRecord, eventID, material, energy, weight, zPos, 0., 0., time};
+        Dispatch(rec);
+}
+
+void HistoManager::FillCherenkov(G4int eventID, G4double energy, G4double weight, G4int secondaries, G4double time,
+                                 G4double timeMin, G4double timeRMS)
+{
+        OutputRecord rec = {kCherenkovRecord, eventID, secondaries, energy, weight, time, timeRMS, 0., timeMin};
+        Dispatch(rec);
+}
+
+void HistoManager::FillDet(G4int eventID, G4double energy, G4double weight, G4int creatorProcess, G4double time)
+{
+        OutputRecord rec = {kDetRecord, eventID, creatorProcess, energy, weight, time};
+        Dispatch(rec);
+}
+
+void HistoManager::FillIncDet(G4int eventID, G4double energy, G4double weight, G4int detProcess)
+{
+        OutputRecord rec = {kIncDetRecord, eventID, detProcess, energy, weight, 0.};
+        Dispatch(rec);
+}
+
+void HistoManager::FillNRFToCher(G4int eventID, G4double nrfEnergy, G4double nrfWeight, G4double cherEnergy, G4double cherWeight)
+{
+        OutputRecord rec = {kNRFToCherRecord, eventID, 0, nrfEnergy, nrfWeight, 0., cherEnergy, cherWeight, 0.};
+        Dispatch(rec);
+}
+
+void HistoManager::FillNRFToCherToDet(G4int eventID, G4double nrfEnergy, G4double nrfWeight, G4double cherEnergy, G4double cherWeight,
+                                      G4double nrfTime, G4double detTime)
+{
+        OutputRecord rec = {kNRFToCherToDetRecord, eventID, 0, nrfEnergy, nrfWeight, nrfTime, cherEnergy, cherWeight, detTime};
+        Dispatch(rec);
+}
+
+void HistoManager::Dispatch(const OutputRecord& rec)
+{
+        // a skipped run still processes the event in which it was aborted
+        if(!fFactoryOn)
+                return;
+        if(fQueue)
+                fQueue->Push(rec);
+        else
+                WriteRecord(rec);
+}
+
+void HistoManager::WriteRecord(const OutputRecord& rec)
+{
+        if(rec.type == kH1Record)
+        {
+                if(!sparseHistos.empty())
+                {
+                        G4double x = rec.energy;
+                        sparseHistos[rec.id]->Fill(&x, rec.weight);
+                }
+                else
+                        fManager->FillH1(rec.id, rec.energy, rec.weight);
+                return;
+        }
+
+#ifdef MANTIS_RNTUPLE
+        if(fRNTuple)
+        {
+                switch(rec.type)
+                {
+                case kChopInRecord:    fRNTuple->FillChopIn(rec.id, rec.energy, rec.weight); break;
+                case kChopOutRecord:   fRNTuple->FillChopOut(rec.id, rec.energy, rec.weight, rec.code); break;
+                case kNRFRecord:       fRNTuple->FillNRF(rec.id, rec.energy, rec.weight, rec.code, rec.extra, rec.time2); break;
+                case kCherenkovRecord: fRNTuple->FillCherenkov(rec.id, rec.energy, rec.weight, rec.code, rec.extra, rec.time2, rec.energy2); break;
+                case kDetRecord:       fRNTuple->FillDet(rec.id, rec.energy, rec.weight, rec.code, rec.extra); break;
+                case kIncDetRecord:    fRNTuple->FillIncDet(rec.id, rec.energy, rec.weight, rec.code); break;
+                case kNRFToCherRecord: fRNTuple->FillNRFToCher(rec.id, rec.energy, rec.weight, rec.energy2, rec.weight2); break;
+                case kNRFToCherToDetRecord:
+                        fRNTuple->FillNRFToCherToDet(rec.id, rec.energy, rec.weight, rec.energy2, rec.weight2, rec.extra, rec.time2);
+                        break;
+                }
+                return;
+        }
+#endif
+
+        switch(rec.type)
+        {
+        case kChopInRecord:
+                fManager->FillNtupleDColumn(0,0, rec.energy);
+                fManager->FillNtupleDColumn(0,1, rec.weight);
+                fManager->FillNtupleIColumn(0,2, rec.id);
+                fManager->AddNtupleRow(0);
+                break;
+        case kChopOutRecord:
+                fManager->FillNtupleDColumn(1,0, rec.energy);
+                fManager->FillNtupleDColumn(1,1, rec.weight);
+                fManager->FillNtupleIColumn(1,2, rec.id);
+                fManager->FillNtupleIColumn(1,3, rec.code);
+                fManager->AddNtupleRow(1);
+                break;
+        case kNRFRecord:
+                fManager->FillNtupleIColumn(2,0, rec.id);
+                fManager->FillNtupleDColumn(2,1, rec.energy);
+                fManager->FillNtupleDColumn(2,2, rec.weight);
+                fManager->FillNtupleIColumn(2,3, rec.code);
+                fManager->FillNtupleDColumn(2,4, rec.extra);
+                fManager->FillNtupleDColumn(2,5, rec.time2);
+                fManager->FillNtupleIColumn(2,6, (G4int)seed);
+                fManager->AddNtupleRow(2);
+                break;
+        case kCherenkovRecord:
+                fManager->FillNtupleDColumn(3,0, rec.energy);
+                fManager->FillNtupleDColumn(3,1, rec.weight);
+                fManager->FillNtupleIColumn(3,2, rec.id);
+                fManager->FillNtupleIColumn(3,3, rec.code);
+                fManager->FillNtupleDColumn(3,4, rec.extra);
+                fManager->FillNtupleDColumn(3,5, rec.time2);
+                fManager->FillNtupleDColumn(3,6, rec.energy2);
+                fManager->FillNtupleIColumn(3,7, (G4int)seed);
+                fManager->AddNtupleRow(3);
+                break;
+        case kDetRecord:
+                fManager->FillNtupleIColumn(4,0, rec.id);
+                fManager->FillNtupleDColumn(4,1, rec.energy);
+                fManager->FillNtupleDColumn(4,2, rec.weight);
+                fManager->FillNtupleIColumn(4,3, rec.code);
+                fManager->FillNtupleDColumn(4,4, rec.extra);
+                fManager->FillNtupleIColumn(4,5, (G4int)seed);
+                fManager->AddNtupleRow(4);
+                break;
+        case kIncDetRecord:
+                fManager->FillNtupleIColumn(5,0, rec.id);
+                fManager->FillNtupleDColumn(5,1, rec.energy);
+                fManager->FillNtupleDColumn(5,2, rec.weight);
+                fManager->FillNtupleIColumn(5,3, rec.code);
+                fManager->AddNtupleRow(5);
+                break;
+        case kNRFToCherRecord:
+                fManager->FillNtupleIColumn(6,0, rec.id);
+                fManager->FillNtupleDColumn(6,1, rec.energy);
+                fManager->FillNtupleDColumn(6,2, rec.weight);
+                fManager->FillNtupleDColumn(6,3, rec.energy2);
+                fManager->FillNtupleDColumn(6,4, rec.weight2);
+                fManager->AddNtupleRow(6);
+                break;
+        case kNRFToCherToDetRecord:
+                fManager->FillNtupleIColumn(7,0, rec.id);
+                fManager->FillNtupleDColumn(7,1, rec.energy);
+                fManager->FillNtupleDColumn(7,2, rec.energy2);
+                fManager->FillNtupleDColumn(7,3, rec.weight);
+                fManager->FillNtupleDColumn(7,4, rec.weight2);
+                fManager->FillNtupleDColumn(7,5, rec.extra);
+                fManager->FillNtupleDColumn(7,6, rec.time2);
+                fManager->AddNtupleRow(7);
+                break;
+        }
+}
+
+// ******************************************************************************************************************************** //
+// Asynchronous Writer
+// ******************************************************************************************************************************** //
+
+void HistoManager::StartWriter()
+{
+        fQueue = new OutputQueue(queueSize);
+        fWriterRunning.store(true);
+        fWriter = std::thread(&HistoManager::WriterLoop, this);
+        G4cout << "HistoManager::StartWriter -> Output written by the writer thread with a queue of " << queueSize << " records." << G4endl;
+}
+
+void HistoManager::StopWriter()
+{
+        if(!fQueue)
+                return;
+        fWriterRunning.store(false, std::memory_order_release);
+        fWriter.join();
+        G4cout << "HistoManager::StopWriter -> Tracking waited on a full output queue " << fQueue->GetNumberOfStalls() << " times." << G4endl;
+        delete fQueue;
+        fQueue = NULL;
+}
+
+void HistoManager::WriterLoop()
+{
+        // while events are running only this thread touches the analysis manager,
+        // the RNTuple writers and the sparse histograms
+        OutputRecord rec;
+        while(true)
+        {
+                if(fQueue->Pop(rec))
+                {
+                        WriteRecord(rec);
+                        continue;
+                }
+                if(!fWriterRunning.load(std::memory_order_acquire))
+                {
+                        // drain what was pushed before the stop request
+                        while(fQueue->Pop(rec))
+                                WriteRecord(rec);
+                        break;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+}
+
+// ******************************************************************************************************************************** //
+// Checkpointing
+// ******************************************************************************************************************************** //
+
+G4String HistoManager::PartName(G4int part) const
+{
+        return gOutName + "_part" + std::to_string(part);
+}
+
+void HistoManager::EndOfEvent(G4int eventID)
+{
+        if(!fFactoryOn || !useParts)
+                return;
+
+        fEventsDone = eventID + 1;
+        if(fEventsDone >= fTotalEvents)
+        {
+                // a resumed run stops once the events of the original run are done
+                if(fEventOffset > 0)
+                        G4RunManager::GetRunManager()->AbortRun(true);
+                return;
+        }
+
+        G4bool due = (checkpointEvents > 0 && fEventsDone - fEventsAtCheckpoint >= checkpointEvents);
+        if(checkpointSeconds > 0 && difftime(time(0), fLastCheckpoint) >= checkpointSeconds)
+                due = true;
+        if(due)
+                Checkpoint();
+}
+
+void HistoManager::Checkpoint()
+{
+        StopWriter();
+        WritePart();
+        WriteCheckpoint();
+        ++fPart;
+        if(!fManager->OpenFile(PartName(fPart)))
+        {
+                G4cerr << "FATAL ERROR HistoManager::Checkpoint: Cannot Open " << PartName(fPart) << G4endl;
+                exit(1);
+        }
+        if(async)
+                StartWriter();
+        fEventsAtCheckpoint = fEventsDone;
+        fLastCheckpoint = time(0);
+        G4cout << "HistoManager::Checkpoint -> " << fEventsDone << " events written in " << fPart << " parts." << G4endl;
+}
+
+void HistoManager::WritePart()
+{
+        // closing the file resets the histograms and ntuples for the next part
+        fManager->Write();
+        fManager->CloseFile();
+
+        G4String partName = PartName(fPart) + ".root";
+        TFile *fpart = TFile::Open(partName.c_str(), "UPDATE");
+        if(!fpart || fpart->IsZombie())
+        {
+                G4cerr << "FATAL ERROR HistoManager::WritePart: Could not update " << partName << G4endl;
+                exit(1);
+        }
+        for(unsigned int i=0; i<sparseHistos.size(); ++i)
+        {
+                sparseHistos[i]->Write();
+                sparseHistos[i]->Reset();
+        }
+        fpart->Close();
+}
+
+void HistoManager::WriteCheckpoint()
+{
+        // write to a temporary file and rename it so a checkpoint is never partially written
+        G4String chkName = gOutName + ".checkpoint";
+        G4String tmpName = chkName + ".tmp";
+        std::ofstream out(tmpName.c_str());
+        out << "seed " << seed << std::endl;
+        out << "events " << fEventsDone << std::endl;
+        out << "parts " << fPart + 1 << std::endl;
+        CLHEP::HepRandom::getTheEngine()->put(out);
+        out.close();
+        if(!out || std::rename(tmpName.c_str(), chkName.c_str()) != 0)
+                G4cerr << "ERROR HistoManager::WriteCheckpoint: Could not write " << chkName << G4endl;
+}
+
+void HistoManager::ReadCheckpoint()
+{
+        G4String chkName = gOutName + ".checkpoint";
+        std::ifstream in(chkName.c_str());
+        if(!in)
+        {
+                G4cout << "HistoManager::ReadCheckpoint -> No checkpoint " << chkName << " found. Starting from the first event." << G4endl;
+                return;
+        }
+
+        G4String key;
+        G4long chkSeed;
+        G4int nParts;
+        in >> key >> chkSeed >> key >> fEventsDone >> key >> nParts;
+        if(!in || chkSeed != seed)
+        {
+                G4cerr << "FATAL ERROR HistoManager::ReadCheckpoint: " << chkName << " is corrupt or was written with a different seed." << G4endl;
+                exit(1);
+        }
+        // all sampling uses the Geant4 engine so its state is the whole random state of the run
+        if(!CLHEP::HepRandom::getTheEngine()->get(in))
+        {
+                G4cerr << "FATAL ERROR HistoManager::ReadCheckpoint: " << chkName << " was written with a different random engine." << G4endl;
+                exit(1);
+        }
+
+        fPart = nParts;
+        G4cout << "HistoManager::ReadCheckpoint -> Resuming after " << fEventsDone << " events from " << nParts << " parts." << G4endl;
+}
+
+void HistoManager::MergeParts()
+{
+        G4String fileName = gOutName + ".root";
+        TFileMerger merger(kFALSE);
+        merger.OutputFile(fileName.c_str(), "RECREATE", compressionLevel);
+        for(G4int i=0; i<=fPart; ++i)
+                merger.AddFile((PartName(i) + ".root").c_str());
+        if(!merger.PartialMerge(TFileMerger::kAll | TFileMerger::kRegular))
+        {
+                G4cerr << "ERROR HistoManager::MergeParts: Could not merge the output parts. Keeping " << gOutName << "_part*.root" << G4endl;
+                return;
+        }
+
+        // the final checkpoint is kept, a resubmitted run finds the run complete and leaves the output alone
+        for(G4int i=0; i<=fPart; ++i)
+                gSystem->Unlink((PartName(i) + ".root").c_str());
+        G4cout << "HistoManager::MergeParts -> Merged " << fPart+1 << " parts into " << fileName << G4endl;
+}
+
+void HistoManager::CreateH1(const G4String& name, const G4String& title, G4double xmin, G4double xmax_in, const G4String& unit)
+{
+        // the photocathode energy spectrum is always 1000 uniform bins
+        G4bool opticalAxis = (unit == "eV");
+        // Brem test output is read back in as the input spectrum so it is never sparse
+        if(binning == "sparse" && !bremTest)
+        {
+                Int_t nb = opticalAxis ? 1000 : (Int_t)((xmax_in - xmin)/(fineBinWidth/(MeV)));
+                Double_t low = xmin;
+                Double_t up = xmax_in;
+                sparseHistos.push_back(new THnSparseD(name.c_str(), title.c_str(), 1, &nb, &low, &up));
+                return;
+        }
+
+        G4AnalysisManager* manager = G4AnalysisManager::Instance();
+        if(opticalAxis)
+                manager->CreateH1(name, title, 1000, xmin, xmax_in, unit);
+        else
+                manager->CreateH1(name, title, edges, unit);
+}
+
+void HistoManager::BuildEdges()
+{
+        G4double coarse = binWidth/(MeV);
+        G4double fine = fineBinWidth/(MeV);
+        G4double window = resonanceWindow/(MeV);
+
+        // merge overlapping resonance windows
+        std::vector<std::pair<G4double, G4double> > windows;
+        if(binning == "resonance")
+        {
+                std::sort(resonances.begin(), resonances.end());
+                for(unsigned int i=0; i<resonances.size(); ++i)
+                {
+                        G4double lo = std::max(0., resonances[i] - window);
+                        G4double hi = std::min(xmax, resonances[i] + window);
+                        if(lo >= hi)
+                                continue;
+                        if(!windows.empty() && lo <= windows.back().second)
+                                windows.back().second = std::max(windows.back().second, hi);
+                        else
+                                windows.push_back(std::make_pair(lo, hi));
+                }
+        }
+
+        edges.clear();
+        edges.push_back(0.);
+        G4double x = 0.;
+        unsigned int w = 0;
+        while(x < xmax)
+        {
+                if(w < windows.size() && x + coarse > windows[w].first)
+                {
+                        // close the coarse bin at the window and fill the window with fine bins
+                        if(windows[w].first > x)
+                                edges.push_back(windows[w].first);
+                        G4int nFine = std::ceil((windows[w].second - windows[w].first)/fine);
+                        for(G4int k=1; k<=nFine; ++k)
+                                edges.push_back(std::min(windows[w].first + k*fine, windows[w].second));
+                        x = windows[w].second;
+                        ++w;
+                }
+                else
+                {
+                        x = std::min(x + coarse, xmax);
+                        edges.push_back(x);
+                }
+        }
+        G4cout << "HistoManager::BuildEdges -> " << binning << " binning with " << edges.size()-1 << " bins." << G4endl;
+}
@@ -0,0 +1,197 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "HistoMessenger.hh"
+
+
+HistoMessenger::HistoMessenger(HistoManager* histoManager)
+        : histoM(histoManager)
+{
+        CmdBinning = new G4UIcmdWithAString("/output/binning",this);
+        CmdBinWidth = new G4UIcmdWithADouble("/output/binWidth",this);
+        CmdFineBinWidth = new G4UIcmdWithADouble("/output/fineBinWidth",this);
+        CmdWindow = new G4UIcmdWithADouble("/output/resonanceWindow",this);
+        CmdFormat = new G4UIcmdWithAString("/output/format",this);
+        CmdCompression = new G4UIcmdWithAString("/output/compression",this);
+        CmdCompressionLevel = new G4UIcmdWithAnInteger("/output/compressionLevel",this);
+        CmdClusterSize = new G4UIcmdWithADouble("/output/clusterSize",this);
+        CmdAsync = new G4UIcmdWithABool("/output/asyncWriter",this);
+        CmdQueueSize = new G4UIcmdWithAnInteger("/output/queueSize",this);
+        CmdCheckpointEvents = new G4UIcmdWithAnInteger("/output/checkpointEvents",this);
+        CmdCheckpointSeconds = new G4UIcmdWithADouble("/output/checkpointSeconds",this);
+        CmdAnalysisThreads = new G4UIcmdWithAnInteger("/output/analysisThreads",this);
+        CmdFileName = new G4UIcmdWithAString("/output/filename",this);
+
+        CmdBinning->SetGuidance("Choose the energy histogram binning");
+        CmdBinning->SetGuidance("uniform (default): coarse uniform bins of width /output/binWidth");
+        CmdBinning->SetGuidance("resonance: coarse bins with fine bins inside windows around the hSample resonances");
+        CmdBinning->SetGuidance("sparse: fine bins stored as THnSparseD, only filled bins are kept");
+        CmdBinWidth->SetGuidance("Choose the coarse bin width in keV");
+        CmdFineBinWidth->SetGuidance("Choose the fine bin width in eV used in resonance windows and sparse histograms");
+        CmdWindow->SetGuidance("Choose the half width in eV of the fine binned window around each resonance");
+        CmdFormat->SetGuidance("Choose the ntuple output format: TTree (default) or RNTuple");
+        CmdCompression->SetGuidance("Choose the RNTuple compression algorithm: zstd (default), lz4, zlib or none");
+        CmdCompressionLevel->SetGuidance("Choose the output compression level (default 5)");
+        CmdClusterSize->SetGuidance("Choose the approximate compressed RNTuple cluster size in MB (default 50)");
+        CmdAsync->SetGuidance("Write the output from a separate I/O thread fed by a bounded queue (default false)");
+        CmdQueueSize->SetGuidance("Choose the number of records the output queue holds, rounded up to a power of two (default 65536)");
+        CmdCheckpointEvents->SetGuidance("Write the output and a checkpoint every N events (default 0, off)");
+        CmdCheckpointSeconds->SetGuidance("Write the output and a checkpoint every T seconds (default 0, off)");
+        CmdCheckpointEvents->SetGuidance("Requires /output/format TTree");
+        CmdCheckpointSeconds->SetGuidance("Requires /output/format TTree");
+        CmdAnalysisThreads->SetGuidance("Choose the number of threads used to fill the weighted histograms after the run (default 0, sequential)");
+        CmdFileName->SetGuidance("Choose the output file name of the next run (default from -o)");
+        CmdBinning->SetParameterName("binning",false);
+        CmdBinWidth->SetParameterName("binWidth",false);
+        CmdFineBinWidth->SetParameterName("fineBinWidth",false);
+        CmdWindow->SetParameterName("window",false);
+        CmdFormat->SetParameterName("format",false);
+        CmdCompression->SetParameterName("compression",false);
+        CmdCompressionLevel->SetParameterName("level",false);
+        CmdClusterSize->SetParameterName("clusterSize",false);
+        CmdAsync->SetParameterName("async",false);
+        CmdQueueSize->SetParameterName("queueSize",false);
+        CmdCheckpointEvents->SetParameterName("checkpointEvents",false);
+        CmdCheckpointSeconds->SetParameterName("checkpointSeconds",false);
+        CmdAnalysisThreads->SetParameterName("analysisThreads",false);
+        CmdFileName->SetParameterName("filename",false);
+        CmdBinning->SetCandidates("uniform resonance sparse");
+        CmdFormat->SetCandidates("TTree RNTuple");
+        CmdCompression->SetCandidates("zstd lz4 zlib none");
+        CmdCompressionLevel->SetRange("level >= 0 && level <= 9");
+        CmdClusterSize->SetRange("clusterSize > 0");
+        CmdBinWidth->SetRange("binWidth > 0");
+        CmdFineBinWidth->SetRange("fineBinWidth > 0");
+        CmdWindow->SetRange("window > 0");
+        CmdQueueSize->SetRange("queueSize > 0");
+        CmdCheckpointEvents->SetRange("checkpointEvents >= 0");
+        CmdCheckpointSeconds->SetRange("checkpointSeconds >= 0");
+        CmdAnalysisThreads->SetRange("analysisThreads >= 0");
+}
+
+HistoMessenger::~HistoMessenger()
+{
+        delete CmdBinning;
+        delete CmdBinWidth;
+        delete CmdFineBinWidth;
+        delete CmdWindow;
+        delete CmdFormat;
+        delete CmdCompression;
+        delete CmdCompressionLevel;
+        delete CmdClusterSize;
+        delete CmdAsync;
+        delete CmdQueueSize;
+        delete CmdCheckpointEvents;
+        delete CmdCheckpointSeconds;
+        delete CmdAnalysisThreads;
+        delete CmdFileName;
+}
+
+void HistoMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+        if(command == CmdBinning)
+        {
+                histoM->SetBinning(newValue);
+                G4cout << "Histogram binning set to: " << newValue << G4endl;
+        }
+        else if(command == CmdBinWidth)
+        {
+                G4double theBinWidth = CmdBinWidth->GetNewDoubleValue(newValue);
+                histoM->SetBinWidth(theBinWidth*keV);
+                G4cout << "Histogram coarse bin width set to: " << theBinWidth << " keV" << G4endl;
+        }
+        else if(command == CmdFineBinWidth)
+        {
+                G4double theFineBinWidth = CmdFineBinWidth->GetNewDoubleValue(newValue);
+                histoM->SetFineBinWidth(theFineBinWidth*eV);
+                G4cout << "Histogram fine bin width set to: " << theFineBinWidth << " eV" << G4endl;
+        }
+        else if(command == CmdWindow)
+        {
+                G4double theWindow = CmdWindow->GetNewDoubleValue(newValue);
+                histoM->SetResonanceWindow(theWindow*eV);
+                G4cout << "Histogram resonance window half width set to: " << theWindow << " eV" << G4endl;
+        }
+        else if(command == CmdFormat)
+        {
+                histoM->SetFormat(newValue);
+                G4cout << "Ntuple output format set to: " << newValue << G4endl;
+        }
+        else if(command == CmdCompression)
+        {
+                histoM->SetCompression(newValue);
+                G4cout << "Output compression set to: " << newValue << G4endl;
+        }
+        else if(command == CmdCompressionLevel)
+        {
+                G4int theLevel = CmdCompressionLevel->GetNewIntValue(newValue);
+                histoM->SetCompressionLevel(theLevel);
+                G4cout << "Output compression level set to: " << theLevel << G4endl;
+        }
+        else if(command == CmdClusterSize)
+        {
+                G4double theClusterSize = CmdClusterSize->GetNewDoubleValue(newValue);
+                histoM->SetClusterSize(theClusterSize);
+                G4cout << "RNTuple cluster size set to: " << theClusterSize << " MB" << G4endl;
+        }
+        else if(command == CmdAsync)
+        {
+                G4bool theAsync = CmdAsync->GetNewBoolValue(newValue);
+                histoM->SetAsync(theAsync);
+                G4cout << "Asynchronous output writer set to: " << theAsync << G4endl;
+        }
+        else if(command == CmdQueueSize)
+        {
+                G4int theQueueSize = CmdQueueSize->GetNewIntValue(newValue);
+                histoM->SetQueueSize(theQueueSize);
+                G4cout << "Output queue size set to: " << theQueueSize << " records" << G4endl;
+        }
+        else if(command == CmdCheckpointEvents)
+        {
+                G4int theEvents = CmdCheckpointEvents->GetNewIntValue(newValue);
+                histoM->SetCheckpointEvents(theEvents);
+                G4cout << "Checkpoint interval set to: " << theEvents << " events" << G4endl;
+        }
+        else if(command == CmdCheckpointSeconds)
+        {
+                G4double theSeconds = CmdCheckpointSeconds->GetNewDoubleValue(newValue);
+                histoM->SetCheckpointSeconds(theSeconds);
+                G4cout << "Checkpoint interval set to: " << theSeconds << " s" << G4endl;
+        }
+        else if(command == CmdAnalysisThreads)
+        {
+                G4int theThreads = CmdAnalysisThreads->GetNewIntValue(newValue);
+                histoM->SetAnalysisThreads(theThreads);
+                G4cout << "Weighted histogram analysis threads set to: " << theThreads << G4endl;
+        }
+        else if(command == CmdFileName)
+        {
+                histoM->SetOutputName(newValue);
+                G4cout << "Output file name set to: " << newValue << G4endl;
+        }
+        else
+        {
+                G4cerr << "ERROR HistoMessenger :: SetNewValue command not found." << G4endl;
+        }
+}
@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "NRFBiasingOperator.hh"
+#include "G4BiasingProcessSharedData.hh"
+#include "G4Gamma.hh"
+#include "G4ProcessManager.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4AffineTransform.hh"
+#include "G4Track.hh"
+#include <algorithm>
+#include <cfloat>
+
+NRFBiasingOperator::NRFBiasingOperator(G4String name)
+        : G4VBiasingOperator(name), forcing(5.)
+{
+}
+
+NRFBiasingOperator::~NRFBiasingOperator()
+{
+        std::map<const G4BiasingProcessInterface*, G4BOptnChangeCrossSection*>::iterator it;
+        for(it = fChangeCrossSection.begin(); it != fChangeCrossSection.end(); ++it)
+                delete it->second;
+}
+
+void NRFBiasingOperator::StartRun()
+{
+        // the wrapped processes are known once the physics is built, one operation per process
+        if(!fChangeCrossSection.empty())
+                return;
+        const G4BiasingProcessSharedData* sharedData =
+                G4BiasingProcessInterface::GetSharedData(G4Gamma::Definition()->GetProcessManager());
+        if(!sharedData)
+        {
+                G4cerr << "ERROR NRFBiasingOperator::StartRun -> NRF is not wrapped for biasing." << G4endl;
+                return;
+        }
+        for(size_t i=0; i<(sharedData->GetPhysicsBiasingProcessInterfaces()).size(); ++i)
+        {
+                const G4BiasingProcessInterface* wrapperProcess = (sharedData->GetPhysicsBiasingProcessInterfaces())[i];
+                G4String operationName = "XSchange-" + wrapperProcess->GetWrappedProcess()->GetProcessName();
+                fChangeCrossSection[wrapperProcess] = new G4BOptnChangeCrossSection(operationName);
+        }
+        G4cout << "NRFBiasingOperator::StartRun -> Forcing NRF with " << forcing << " interaction lengths per volume." << G4endl;
+}
+
+G4VBiasingOperation* NRFBiasingOperator::ProposeOccurenceBiasingOperation(const G4Track* track,
+                                                                          const G4BiasingProcessInterface* callingProcess)
+{
+        if(track->GetDefinition() != G4Gamma::Definition()
+           || callingProcess->GetWrappedProcess()->GetProcessName() != "NRF")
+                return 0;
+
+        // off resonance there is nothing to force
+        G4double analogInteractionLength = callingProcess->GetWrappedProcess()->GetCurrentInteractionLength();
+        if(analogInteractionLength > DBL_MAX/10.)
+                return 0;
+        G4double analogXS = 1./analogInteractionLength;
+
+        // distance left to the surface of the biased volume along the flight direction
+        const G4AffineTransform* transform = &(track->GetTouchable()->GetHistory()->GetTopTransform());
+        G4double distance = track->GetTouchable()->GetSolid()->DistanceToOut(transform->TransformPoint(track->GetPosition()),
+                                                                             transform->TransformAxis(track->GetMomentumDirection()));
+        G4double biasedXS = distance > 0. ? std::max(analogXS, forcing/distance) : analogXS;
+
+        std::map<const G4BiasingProcessInterface*, G4BOptnChangeCrossSection*>::iterator it = fChangeCrossSection.find(callingProcess);
+        if(it == fChangeCrossSection.end())
+                return 0;
+        G4BOptnChangeCrossSection* operation = it->second;
+
+        G4VBiasingOperation* previousOperation = callingProcess->GetPreviousOccurenceBiasingOperation();
+        if(previousOperation == 0 || operation->GetInteractionOccured())
+        {
+                operation->SetBiasedCrossSection(biasedXS);
+                operation->Sample();
+        }
+        else if(previousOperation != operation)
+        {
+                return 0;
+        }
+        else
+        {
+                // keep the interaction lengths already travelled and continue with the new cross section
+                operation->UpdateForStep(callingProcess->GetPreviousStepSize());
+                operation->SetBiasedCrossSection(biasedXS);
+                operation->UpdateForStep(0.0);
+        }
+        return operation;
+}
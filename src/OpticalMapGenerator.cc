@@ -0,0 +1,292 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OpticalMapGenerator.hh"
+#include "OpticalMapMessenger.hh"
+#include "OpticalResponseMap.hh"
+#include "G4RunManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Box.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include "TFile.h"
+#include "TNamed.h"
+#include "TSystem.h"
+#include "TVectorD.h"
+#include "TVectorF.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+extern G4long seed;
+
+OpticalMapGenerator::OpticalMapGenerator(const DetectorConstruction* det)
+        : G4VUserPrimaryGeneratorAction(), local_det(det), mapM(NULL), fParticleGun(NULL), fNavigator(NULL),
+        halfX(0.), halfY(0.), halfZ(0.),
+        nx(10), ny(10), nz(10), nCos(10), nPhi(12), nE(10), nPhotons(100), nWorkers(0), nPMT(0),
+        Emin(2.034*eV), Emax(4.136*eV), firstBin(0), currentBin(-1)
+{
+        mapM = new OpticalMapMessenger(this);
+        fParticleGun = new G4ParticleGun(1);
+        fParticleGun->SetParticleDefinition(G4OpticalPhoton::Definition());
+        fParticleGun->SetParticleTime(0.0*ns);
+        G4cout << "OpticalMapGenerator::Particle Type set to Optical Photon!" << G4endl;
+}
+
+OpticalMapGenerator::~OpticalMapGenerator()
+{
+        delete fParticleGun;
+        delete fNavigator;
+        delete mapM;
+}
+
+G4bool OpticalMapGenerator::FindWater(G4LogicalVolume* mother, const G4AffineTransform& toGlobal)
+{
+        for(size_t i=0; i<mother->GetNoDaughters(); ++i)
+        {
+                G4VPhysicalVolume* daughter = mother->GetDaughter(i);
+                G4AffineTransform daughterToGlobal = G4AffineTransform(daughter->GetRotation(), daughter->GetTranslation())*toGlobal;
+                if(daughter->GetName() == "Water")
+                {
+                        G4Box* solidWater = (G4Box*) daughter->GetLogicalVolume()->GetSolid();
+                        halfX = solidWater->GetXHalfLength();
+                        halfY = solidWater->GetYHalfLength();
+                        halfZ = solidWater->GetZHalfLength();
+                        nPMT = 0;
+                        for(size_t k=0; k<daughter->GetLogicalVolume()->GetNoDaughters(); ++k)
+                                if(daughter->GetLogicalVolume()->GetDaughter(k)->GetName() == "PMT")
+                                        ++nPMT;
+                        waterToGlobal = daughterToGlobal;
+                        return true;
+                }
+                if(FindWater(daughter->GetLogicalVolume(), daughterToGlobal))
+                        return true;
+        }
+        return false;
+}
+
+void OpticalMapGenerator::GeneratePrimaries(G4Event* anEvent)
+{
+        currentBin = firstBin + anEvent->GetEventID()/nPhotons;
+        G4int bin = currentBin;
+        G4int iE = bin % nE; bin /= nE;
+        G4int iPhi = bin % nPhi; bin /= nPhi;
+        G4int iCos = bin % nCos; bin /= nCos;
+        G4int iz = bin % nz; bin /= nz;
+        G4int iy = bin % ny;
+        G4int ix = bin / ny;
+
+        // the grid covers the whole box, positions inside a PMT are drawn again
+        G4ThreeVector localPos, position;
+        for(G4int tries=0; tries<100; ++tries)
+        {
+                localPos.set(-halfX + 2.*halfX*(ix + G4UniformRand())/nx,
+                             -halfY + 2.*halfY*(iy + G4UniformRand())/ny,
+                             -halfZ + 2.*halfZ*(iz + G4UniformRand())/nz);
+                position = waterToGlobal.TransformPoint(localPos);
+                G4VPhysicalVolume* volume = fNavigator->LocateGlobalPointAndSetup(position, 0, false, true);
+                if(volume && volume->GetName() == "Water")
+                        break;
+        }
+        G4double cosTheta = -1. + 2.*(iCos + G4UniformRand())/nCos;
+        G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta*cosTheta));
+        G4double phi = -pi + twopi*(iPhi + G4UniformRand())/nPhi;
+        G4ThreeVector localDir(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+        G4ThreeVector direction = waterToGlobal.TransformAxis(localDir);
+        G4ThreeVector polarization = direction.orthogonal().unit().rotate(twopi*G4UniformRand(), direction);
+
+        fParticleGun->SetParticleEnergy(Emin + (Emax - Emin)*(iE + G4UniformRand())/nE);
+        fParticleGun->SetParticlePosition(position);
+        fParticleGun->SetParticleMomentumDirection(direction);
+        fParticleGun->SetParticlePolarization(polarization);
+        fParticleGun->GeneratePrimaryVertex(anEvent);
+}
+
+void OpticalMapGenerator::Detected(G4int pmt, G4double time)
+{
+        if(currentBin < 0 || pmt < 1 || pmt > nPMT)
+                return;
+        G4int i = (currentBin - firstBin)*nPMT + pmt - 1;
+        counts[i] += 1.;
+        sumTime[i] += time/(ns);
+        sumTime2[i] += time/(ns)*time/(ns);
+}
+
+G4bool OpticalMapGenerator::RunWorker(G4int first, G4int last, const G4String& partName)
+{
+        firstBin = first;
+        counts.assign((size_t)(last - first)*nPMT, 0.);
+        sumTime.assign(counts.size(), 0.);
+        sumTime2.assign(counts.size(), 0.);
+        G4RunManager::GetRunManager()->BeamOn((last - first)*nPhotons);
+        currentBin = -1;
+
+        std::ofstream out(partName.c_str(), std::ios::binary);
+        out.write((const char*)counts.data(), counts.size()*sizeof(G4double));
+        out.write((const char*)sumTime.data(), sumTime.size()*sizeof(G4double));
+        out.write((const char*)sumTime2.data(), sumTime2.size()*sizeof(G4double));
+        return out.good();
+}
+
+void OpticalMapGenerator::Generate(const G4String& fileName)
+{
+        G4RunManager* runManager = G4RunManager::GetRunManager();
+        G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+        if(!world || !FindWater(world->GetLogicalVolume(), G4AffineTransform()))
+        {
+                G4cerr << "ERROR OpticalMapGenerator::Generate -> No Water volume, call /run/initialize first." << G4endl;
+                return;
+        }
+        if(!fNavigator)
+                fNavigator = new G4Navigator();
+        fNavigator->SetWorldVolume(world);
+
+        G4int nBins = GetNumberOfBins();
+        if(nBins <= 0 || nPhotons <= 0 || nPMT <= 0 || Emax <= Emin)
+        {
+                G4cerr << "ERROR OpticalMapGenerator::Generate -> Check the /optical/map binning." << G4endl;
+                return;
+        }
+        G4String signature = local_det->GetOpticalSignature();
+
+        // regenerate only if the tank or the binning changed since the map was written
+        if(gSystem->AccessPathName(fileName.c_str()) == 0)
+        {
+                OpticalResponseMap oldMap;
+                if(oldMap.Load(fileName) && oldMap.GetSignature() == signature && oldMap.GetNumberOfBins() == nBins
+                   && oldMap.GetNumberOfPMTs() == nPMT)
+                {
+                        G4cout << "OpticalMapGenerator::Generate -> " << fileName << " is up to date for " << signature << G4endl;
+                        return;
+                }
+                G4cout << "OpticalMapGenerator::Generate -> " << fileName << " was made for another tank or binning, regenerating." << G4endl;
+        }
+
+        G4int workers = nWorkers > 0 ? nWorkers : std::max((G4int)std::thread::hardware_concurrency(), 1);
+        workers = std::min(workers, nBins);
+        G4int binsPerWorker = (nBins + workers - 1)/workers;
+        workers = (nBins + binsPerWorker - 1)/binsPerWorker;
+        if((G4double)binsPerWorker*nPhotons > std::numeric_limits<G4int>::max())
+        {
+                G4cerr << "ERROR OpticalMapGenerator::Generate -> Too many photons per worker, use more workers or fewer photons per bin." << G4endl;
+                return;
+        }
+        G4cout << "OpticalMapGenerator::Generate -> " << nBins << " bins x " << nPhotons << " photons for " << nPMT
+               << " PMTs on " << workers << " workers" << G4endl;
+
+        // the physics tables are built once here and shared with the workers
+        runManager->BeamOn(0);
+
+        std::vector<pid_t> pids;
+        for(G4int w=0; w<workers; ++w)
+        {
+                G4int first = w*binsPerWorker;
+                G4int last = std::min(first + binsPerWorker, nBins);
+                pid_t pid = fork();
+                if(pid == 0)
+                {
+                        CLHEP::HepRandom::setTheSeed(seed*1000 + w + 1);
+                        G4bool ok = RunWorker(first, last, fileName + ".part" + std::to_string(w));
+                        _exit(ok ? 0 : 1);
+                }
+                else if(pid < 0)
+                {
+                        G4cerr << "ERROR OpticalMapGenerator::Generate -> Could not start worker " << w << G4endl;
+                        break;
+                }
+                pids.push_back(pid);
+        }
+
+        G4bool ok = (G4int)pids.size() == workers;
+        for(size_t w=0; w<pids.size(); ++w)
+        {
+                int status = 0;
+                waitpid(pids[w], &status, 0);
+                ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+
+        // combine the parts into probability and arrival time per bin and PMT
+        G4int nValues = nBins*nPMT;
+        TVectorF prob(nValues), tMean(nValues), tRMS(nValues);
+        for(size_t w=0; w<pids.size(); ++w)
+        {
+                G4String partName = fileName + ".part" + std::to_string(w);
+                G4int first = w*binsPerWorker;
+                size_t n = (size_t)(std::min(first + binsPerWorker, nBins) - first)*nPMT;
+                std::vector<G4double> c(n), t(n), t2(n);
+                std::ifstream in(partName.c_str(), std::ios::binary);
+                in.read((char*)c.data(), n*sizeof(G4double));
+                in.read((char*)t.data(), n*sizeof(G4double));
+                in.read((char*)t2.data(), n*sizeof(G4double));
+                ok = ok && in.good();
+                in.close();
+                unlink(partName.c_str());
+                for(size_t i=0; i<n && ok; ++i)
+                {
+                        G4int k = first*nPMT + i;
+                        prob[k] = c[i]/nPhotons;
+                        if(c[i] > 0.)
+                        {
+                                tMean[k] = t[i]/c[i];
+                                tRMS[k] = std::sqrt(std::max(0., t2[i]/c[i] - tMean[k]*tMean[k]));
+                        }
+                }
+        }
+        if(!ok)
+        {
+                G4cerr << "ERROR OpticalMapGenerator::Generate -> A worker failed, " << fileName << " was not written." << G4endl;
+                return;
+        }
+
+        TVectorD binning(12);
+        binning[0] = nx; binning[1] = ny; binning[2] = nz;
+        binning[3] = nCos; binning[4] = nPhi; binning[5] = nE;
+        binning[6] = Emin/(eV); binning[7] = Emax/(eV); binning[8] = nPMT;
+        binning[9] = halfX/(mm); binning[10] = halfY/(mm); binning[11] = halfZ/(mm);
+        TNamed geometry("OpticalMapGeometry", signature.c_str());
+
+        TFile *fout = TFile::Open(fileName.c_str(), "RECREATE");
+        if(!fout || fout->IsZombie())
+        {
+                G4cerr << "ERROR OpticalMapGenerator::Generate -> Could not create " << fileName << G4endl;
+                delete fout;
+                return;
+        }
+        binning.Write("OpticalMapBinning");
+        prob.Write("OpticalMapProbability");
+        tMean.Write("OpticalMapTimeMean");
+        tRMS.Write("OpticalMapTimeRMS");
+        geometry.Write();
+        fout->Close();
+        delete fout;
+        G4cout << "OpticalMapGenerator::Generate -> Map written to " << fileName << G4endl;
+}
@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OpticalMapMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include <sstream>
+
+OpticalMapMessenger::OpticalMapMessenger(OpticalMapGenerator* generator)
+        : mapG(generator)
+{
+        myDir = new G4UIdirectory("/optical/map/");
+        myDir->SetGuidance("Optical Response Map Generator Commands (mantis -d true)");
+        CmdBins = new G4UIcmdWithAString("/optical/map/bins",this);
+        CmdBins->SetGuidance("Number of position bins along the water tank x y z (default 10 10 10)");
+        CmdBins->SetParameterName("bins",false);
+        CmdDirectionBins = new G4UIcmdWithAString("/optical/map/directionBins",this);
+        CmdDirectionBins->SetGuidance("Number of direction bins in cos(theta) and phi in the water tank frame (default 10 12)");
+        CmdDirectionBins->SetParameterName("directionBins",false);
+        CmdEnergyBins = new G4UIcmdWithAString("/optical/map/energyBins",this);
+        CmdEnergyBins->SetGuidance("Number of photon energy bins, Emin and Emax in eV (default 10 2.034 4.136, the water refractive index table)");
+        CmdEnergyBins->SetParameterName("energyBins",false);
+        CmdPhotons = new G4UIcmdWithAnInteger("/optical/map/photons",this);
+        CmdPhotons->SetGuidance("Number of photons fired per bin (default 100)");
+        CmdPhotons->SetParameterName("photons",false);
+        CmdPhotons->SetRange("photons > 0");
+        CmdWorkers = new G4UIcmdWithAnInteger("/optical/map/workers",this);
+        CmdWorkers->SetGuidance("Number of worker processes (default 0 = all cores)");
+        CmdWorkers->SetParameterName("workers",false);
+        CmdWorkers->SetRange("workers >= 0");
+        CmdGenerate = new G4UIcmdWithAString("/optical/map/generate",this);
+        CmdGenerate->SetGuidance("Generate the map for the current /mydet settings and write it to the file, after /run/initialize");
+        CmdGenerate->SetGuidance("An existing map of the same tank and binning is kept");
+        CmdGenerate->SetParameterName("mapFile",false);
+}
+
+OpticalMapMessenger::~OpticalMapMessenger()
+{
+        delete CmdBins;
+        delete CmdDirectionBins;
+        delete CmdEnergyBins;
+        delete CmdPhotons;
+        delete CmdWorkers;
+        delete CmdGenerate;
+        delete myDir;
+}
+
+void OpticalMapMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+        if(command == CmdBins)
+        {
+                G4int x = 0, y = 0, z = 0;
+                std::istringstream is(newValue);
+                is >> x >> y >> z;
+                if(x <= 0 || y <= 0 || z <= 0)
+                {
+                        G4cerr << "ERROR OpticalMapMessenger :: /optical/map/bins expects three positive numbers." << G4endl;
+                        return;
+                }
+                mapG->SetBins(x, y, z);
+                G4cout << "Optical map position bins set to: " << x << " " << y << " " << z << G4endl;
+        }
+        else if(command == CmdDirectionBins)
+        {
+                G4int c = 0, p = 0;
+                std::istringstream is(newValue);
+                is >> c >> p;
+                if(c <= 0 || p <= 0)
+                {
+                        G4cerr << "ERROR OpticalMapMessenger :: /optical/map/directionBins expects two positive numbers." << G4endl;
+                        return;
+                }
+                mapG->SetDirectionBins(c, p);
+                G4cout << "Optical map direction bins set to: " << c << " " << p << G4endl;
+        }
+        else if(command == CmdEnergyBins)
+        {
+                G4int n = 0;
+                G4double lo = -1., hi = -1.;
+                std::istringstream is(newValue);
+                is >> n >> lo >> hi;
+                if(n <= 0 || lo <= 0. || hi <= lo)
+                {
+                        G4cerr << "ERROR OpticalMapMessenger :: /optical/map/energyBins expects n Emin Emax[eV] with 0 < Emin < Emax." << G4endl;
+                        return;
+                }
+                mapG->SetEnergyBins(n, lo*eV, hi*eV);
+                G4cout << "Optical map energy bins set to: " << n << " from " << lo << " to " << hi << " eV" << G4endl;
+        }
+        else if(command == CmdPhotons)
+        {
+                G4int theCommand = CmdPhotons->GetNewIntValue(newValue);
+                mapG->SetPhotonsPerBin(theCommand);
+                G4cout << "Optical map photons per bin set to: " << theCommand << G4endl;
+        }
+        else if(command == CmdWorkers)
+        {
+                G4int theCommand = CmdWorkers->GetNewIntValue(newValue);
+                mapG->SetWorkers(theCommand);
+                G4cout << "Optical map workers set to: " << theCommand << G4endl;
+        }
+        else if(command == CmdGenerate)
+        {
+                mapG->Generate(newValue);
+        }
+        else
+        {
+                G4cerr << "ERROR OpticalMapMessenger :: SetNewValue command not found." << G4endl;
+        }
+}
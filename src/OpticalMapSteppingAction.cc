@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OpticalMapSteppingAction.hh"
+#include "G4OpBoundaryProcess.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ProcessManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
+#include "G4SystemOfUnits.hh"
+
+OpticalMapSteppingAction::OpticalMapSteppingAction(OpticalMapGenerator* generator)
+        : G4UserSteppingAction(), kgenerator(generator)
+{
+}
+
+OpticalMapSteppingAction::~OpticalMapSteppingAction()
+{
+}
+
+void OpticalMapSteppingAction::UserSteppingAction(const G4Step* aStep)
+{
+        G4StepPoint* endPoint = aStep->GetPostStepPoint();
+        G4StepPoint* startPoint = aStep->GetPreStepPoint();
+        if(endPoint->GetStepStatus() != fGeomBoundary || !endPoint->GetPhysicalVolume())
+                return;
+
+        // incident photocathode, same condition as SteppingAction
+        if(endPoint->GetPhysicalVolume()->GetName().compare(0,2,"PC") != 0
+           || startPoint->GetPhysicalVolume()->GetName().compare(0,2,"PC") == 0)
+                return;
+
+        G4ProcessManager* OpManager = G4OpticalPhoton::OpticalPhoton()->GetProcessManager();
+        G4int MAXofPostStepLoops = OpManager->GetPostStepProcessVector()->entries();
+        G4ProcessVector* postStepDoItVector = OpManager->GetPostStepProcessVector(typeDoIt);
+        for(G4int i=0; i<MAXofPostStepLoops; ++i)
+        {
+                G4OpBoundaryProcess* opProc = dynamic_cast<G4OpBoundaryProcess*>((*postStepDoItVector)[i]);
+                if(opProc && opProc->GetStatus() == Detection
+                   && aStep->GetTrack()->GetKineticEnergy()/(eV) < 10.0)
+                {
+                        // the PC is placed in its PMT, the PMT copy number is 1 to nPMT
+                        kgenerator->Detected(endPoint->GetTouchable()->GetCopyNumber(1), aStep->GetTrack()->GetGlobalTime());
+                }
+        }
+}
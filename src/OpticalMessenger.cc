@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OpticalMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+OpticalMessenger::OpticalMessenger(StackingAction* stackAction)
+        : stackA(stackAction)
+{
+        myDir = new G4UIdirectory("/optical/");
+        myDir->SetGuidance("Optical Photon Commands");
+        CmdFastMap = new G4UIcmdWithAString("/optical/fastMap",this);
+        CmdFastMap->SetGuidance("Replace the optical photon tracking in the water tanks by the detection probability map in this file");
+        CmdFastMap->SetGuidance("The map must be made for the current /mydet settings, give it after them. none (default) tracks every photon");
+        CmdFastMap->SetParameterName("mapFile",false);
+        CmdThinning = new G4UIcmdWithAnInteger("/optical/thinning",this);
+        CmdThinning->SetGuidance("Track only 1 in k optical photons with k times their weight (default 1, off)");
+        CmdThinning->SetParameterName("thinning",false);
+        CmdThinning->SetRange("thinning >= 1");
+        CmdPreSampleQE = new G4UIcmdWithABool("/optical/preSampleQE",this);
+        CmdPreSampleQE->SetGuidance("Sample the photocathode quantum efficiency when an optical photon is created and only track the accepted ones (default false)");
+        CmdPreSampleQE->SetGuidance("Not applied to photons handled by /optical/fastMap, the map includes the efficiency");
+        CmdPreSampleQE->SetParameterName("preSampleQE",false);
+        CmdMaxPE = new G4UIcmdWithAnInteger("/optical/maxPE",this);
+        CmdMaxPE->SetGuidance("Maximum number of photoelectrons recorded per PMT and event, optical photons are not tracked once every PMT has them (default 0, off)");
+        CmdMaxPE->SetParameterName("maxPE",false);
+        CmdMaxPE->SetRange("maxPE >= 0");
+        CmdMaxTracks = new G4UIcmdWithAnInteger("/optical/maxTracks",this);
+        CmdMaxTracks->SetGuidance("Maximum number of optical photons tracked per event (default 0, off)");
+        CmdMaxTracks->SetParameterName("maxTracks",false);
+        CmdMaxTracks->SetRange("maxTracks >= 0");
+        CmdTimeGate = new G4UIcmdWithADouble("/optical/timeGate",this);
+        CmdTimeGate->SetGuidance("Optical photons created more than this many ns after the first detection of the event are not tracked (default 0, off)");
+        CmdTimeGate->SetParameterName("timeGate",false);
+        CmdTimeGate->SetRange("timeGate >= 0.");
+}
+
+OpticalMessenger::~OpticalMessenger()
+{
+        delete CmdFastMap;
+        delete CmdThinning;
+        delete CmdPreSampleQE;
+        delete CmdMaxPE;
+        delete CmdMaxTracks;
+        delete CmdTimeGate;
+        delete myDir;
+}
+
+void OpticalMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+        if(command == CmdFastMap)
+        {
+                if(stackA->SetOpticalMap(newValue))
+                        G4cout << "Optical response map set to: " << newValue << G4endl;
+        }
+        else if(command == CmdThinning)
+        {
+                G4int theCommand = CmdThinning->GetNewIntValue(newValue);
+                stackA->SetOpticalThinning(theCommand);
+                G4cout << "Optical photon thinning set to: " << theCommand << G4endl;
+        }
+        else if(command == CmdPreSampleQE)
+        {
+                G4bool theCommand = CmdPreSampleQE->GetNewBoolValue(newValue);
+                stackA->SetQEPreSampling(theCommand);
+                G4cout << "Optical photon QE pre-sampling set to: " << theCommand << G4endl;
+        }
+        else if(command == CmdMaxPE)
+        {
+                G4int theCommand = CmdMaxPE->GetNewIntValue(newValue);
+                stackA->SetMaxPE(theCommand);
+                G4cout << "Maximum photoelectrons per PMT set to: " << theCommand << G4endl;
+        }
+        else if(command == CmdMaxTracks)
+        {
+                G4int theCommand = CmdMaxTracks->GetNewIntValue(newValue);
+                stackA->SetMaxOpticalTracks(theCommand);
+                G4cout << "Maximum optical tracks per event set to: " << theCommand << G4endl;
+        }
+        else if(command == CmdTimeGate)
+        {
+                G4double theCommand = CmdTimeGate->GetNewDoubleValue(newValue);
+                stackA->SetTimeGate(theCommand*ns);
+                G4cout << "Optical photon time gate set to: " << theCommand << " ns" << G4endl;
+        }
+        else
+        {
+                G4cerr << "ERROR OpticalMessenger :: SetNewValue command not found." << G4endl;
+        }
+}
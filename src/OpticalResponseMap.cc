@@ -0,0 +1,131 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OpticalResponseMap.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "TFile.h"
+#include "TNamed.h"
+#include "TVectorD.h"
+#include "TVectorF.h"
+#include <algorithm>
+#include <cmath>
+
+OpticalResponseMap::OpticalResponseMap()
+        : nx(0), ny(0), nz(0), nCos(0), nPhi(0), nE(0), nPMT(0),
+        Emin(0.), Emax(0.), halfX(0.), halfY(0.), halfZ(0.)
+{
+}
+
+OpticalResponseMap::~OpticalResponseMap()
+{
+}
+
+G4bool OpticalResponseMap::Load(const G4String& fileName)
+{
+        TFile *fin = TFile::Open(fileName.c_str());
+        if(!fin || fin->IsZombie())
+        {
+                G4cerr << "ERROR OpticalResponseMap::Load -> " << fileName << " NOT FOUND!" << G4endl;
+                delete fin;
+                return false;
+        }
+        TVectorD* binning = (TVectorD*) fin->Get("OpticalMapBinning");
+        TVectorF* prob = (TVectorF*) fin->Get("OpticalMapProbability");
+        TVectorF* tMean = (TVectorF*) fin->Get("OpticalMapTimeMean");
+        TVectorF* tRMS = (TVectorF*) fin->Get("OpticalMapTimeRMS");
+        TNamed* geometry = (TNamed*) fin->Get("OpticalMapGeometry");
+        if(!binning || binning->GetNrows() < 12 || !prob || !tMean || !tRMS || !geometry)
+        {
+                G4cerr << "ERROR OpticalResponseMap::Load -> " << fileName << " is not an optical response map." << G4endl;
+                fin->Close();
+                delete fin;
+                return false;
+        }
+
+        nx = (G4int)(*binning)[0];
+        ny = (G4int)(*binning)[1];
+        nz = (G4int)(*binning)[2];
+        nCos = (G4int)(*binning)[3];
+        nPhi = (G4int)(*binning)[4];
+        nE = (G4int)(*binning)[5];
+        Emin = (*binning)[6]*eV;
+        Emax = (*binning)[7]*eV;
+        nPMT = (G4int)(*binning)[8];
+        halfX = (*binning)[9]*mm;
+        halfY = (*binning)[10]*mm;
+        halfZ = (*binning)[11]*mm;
+        signature = geometry->GetTitle();
+
+        G4int nValues = nx*ny*nz*nCos*nPhi*nE*nPMT;
+        if(prob->GetNrows() != nValues || tMean->GetNrows() != nValues || tRMS->GetNrows() != nValues)
+        {
+                G4cerr << "ERROR OpticalResponseMap::Load -> " << fileName << " binning does not match its tables." << G4endl;
+                fin->Close();
+                delete fin;
+                return false;
+        }
+        probability.assign(prob->GetMatrixArray(), prob->GetMatrixArray() + nValues);
+        timeMean.assign(tMean->GetMatrixArray(), tMean->GetMatrixArray() + nValues);
+        timeRMS.assign(tRMS->GetMatrixArray(), tRMS->GetMatrixArray() + nValues);
+        fin->Close();
+        delete fin;
+
+        G4cout << "OpticalResponseMap::Load -> Loaded " << nValues/nPMT << " bins for " << nPMT << " PMTs from " << fileName << G4endl;
+        return true;
+}
+
+G4int OpticalResponseMap::GetBin(const G4ThreeVector& localPos, const G4ThreeVector& localDir, G4double energy) const
+{
+        if(std::fabs(localPos.x()) >= halfX || std::fabs(localPos.y()) >= halfY || std::fabs(localPos.z()) >= halfZ
+           || energy < Emin || energy >= Emax)
+                return -1;
+        G4int ix = std::min((G4int)((localPos.x() + halfX)/(2.*halfX)*nx), nx - 1);
+        G4int iy = std::min((G4int)((localPos.y() + halfY)/(2.*halfY)*ny), ny - 1);
+        G4int iz = std::min((G4int)((localPos.z() + halfZ)/(2.*halfZ)*nz), nz - 1);
+        G4int iCos = std::min((G4int)((localDir.cosTheta() + 1.)/2.*nCos), nCos - 1);
+        G4int iPhi = std::min((G4int)((localDir.phi() + pi)/twopi*nPhi), nPhi - 1);
+        G4int iE = std::min((G4int)((energy - Emin)/(Emax - Emin)*nE), nE - 1);
+        return ((((ix*ny + iy)*nz + iz)*nCos + iCos)*nPhi + iPhi)*nE + iE;
+}
+
+G4int OpticalResponseMap::Sample(const G4ThreeVector& localPos, const G4ThreeVector& localDir, G4double energy, G4double& delay) const
+{
+        G4int bin = GetBin(localPos, localDir, energy);
+        if(bin < 0)
+                return -1;
+        // a photon is detected by at most one PMT
+        G4double u = G4UniformRand();
+        for(G4int k=0; k<nPMT; ++k)
+        {
+                G4int i = bin*nPMT + k;
+                u -= probability[i];
+                if(u < 0.)
+                {
+                        delay = std::max(G4RandGauss::shoot(timeMean[i], timeRMS[i]), 0.)*ns;
+                        return k;
+                }
+        }
+        return -1;
+}
@@ -0,0 +1,141 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OutputCodes.hh"
+
+std::map<const G4VPhysicalVolume*, G4int> OutputCodes::volumeCodes;
+std::map<const G4VProcess*, G4int> OutputCodes::processCodes;
+
+namespace
+{
+// names match the strings previously written to the DetProcess column
+const char* detProcessNames[kNumDetProcessCodes] = {"Trans", "Refr", "Int_Refl", "Lamb", "Lobe", "Spike", "BackS", "Abs", "Det",
+                                                    "NotAtBoundary", "SameMaterial", "SteptooSmall", "NoRINDEX", "noStatus"};
+}
+
+G4int OutputCodes::GetVolumeCode(const G4VPhysicalVolume* vol)
+{
+        auto it = volumeCodes.find(vol);
+        if(it != volumeCodes.end())
+                return it->second;
+
+        G4PhysicalVolumeStore* store = G4PhysicalVolumeStore::GetInstance();
+        G4int code = -1;
+        for(unsigned int i=0; i<store->size(); ++i)
+        {
+                if((*store)[i] == vol)
+                {
+                        code = i;
+                        break;
+                }
+        }
+        volumeCodes[vol] = code;
+        return code;
+}
+
+G4int OutputCodes::GetProcessCode(const G4VProcess* process)
+{
+        if(process == 0)
+                return 0;
+
+        auto it = processCodes.find(process);
+        if(it != processCodes.end())
+                return it->second;
+
+        G4ProcNameVector* names = G4ProcessTable::GetProcessTable()->GetNameList();
+        G4int code = -1;
+        for(unsigned int i=0; i<names->size(); ++i)
+        {
+                if((*names)[i] == process->GetProcessName())
+                {
+                        code = i+1;
+                        break;
+                }
+        }
+        processCodes[process] = code;
+        return code;
+}
+
+G4int OutputCodes::GetDetProcessCode(G4OpBoundaryProcessStatus theStatus)
+{
+        switch(theStatus)
+        {
+        case Transmission:            return kTrans;
+        case FresnelRefraction:       return kRefr;
+        case TotalInternalReflection: return kIntRefl;
+        case LambertianReflection:    return kLamb;
+        case LobeReflection:          return kLobe;
+        case SpikeReflection:         return kSpike;
+        case BackScattering:          return kBackS;
+        case Absorption:              return kAbs;
+        case Detection:               return kDet;
+        case NotAtBoundary:           return kNotAtBoundary;
+        case SameMaterial:            return kSameMaterial;
+        case StepTooSmall:            return kStepTooSmall;
+        case NoRINDEX:                return kNoRINDEX;
+        default:                      return kNoStatus;
+        }
+}
+
+void OutputCodes::Write(TFile* fout)
+{
+        fout->cd();
+
+        TObjArray materials;
+        materials.SetOwner(kTRUE);
+        G4PhysicalVolumeStore* store = G4PhysicalVolumeStore::GetInstance();
+        for(unsigned int i=0; i<store->size(); ++i)
+                materials.Add(new TObjString((*store)[i]->GetName().c_str()));
+        materials.Write("MaterialCodes", TObject::kSingleKey);
+
+        TObjArray processes;
+        processes.SetOwner(kTRUE);
+        processes.Add(new TObjString("Brem"));
+        G4ProcNameVector* names = G4ProcessTable::GetProcessTable()->GetNameList();
+        for(unsigned int i=0; i<names->size(); ++i)
+                processes.Add(new TObjString((*names)[i].c_str()));
+        processes.Write("CreatorProcessCodes", TObject::kSingleKey);
+
+        TObjArray detProcesses;
+        detProcesses.SetOwner(kTRUE);
+        for(G4int i=0; i<kNumDetProcessCodes; ++i)
+                detProcesses.Add(new TObjString(detProcessNames[i]));
+        detProcesses.Write("DetProcessCodes", TObject::kSingleKey);
+}
+
+G4int OutputCodes::LookUp(TFile* fin, const char* dictName, const char* name)
+{
+        TObjArray* dict = 0;
+        fin->GetObject(dictName, dict);
+        if(!dict)
+        {
+                G4cerr << "OutputCodes::LookUp -> " << dictName << " not found in " << fin->GetName() << G4endl;
+                return -1;
+        }
+        dict->SetOwner(kTRUE);
+        TObject* entry = dict->FindObject(name);
+        G4int code = entry ? dict->IndexOf(entry) : -1;
+        delete dict;
+        return code;
+}
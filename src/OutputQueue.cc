@@ -0,0 +1,64 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OutputQueue.hh"
+#include <thread>
+
+OutputQueue::OutputQueue(std::size_t capacity)
+        : fHead(0), fTail(0), fStalls(0)
+{
+        // round the capacity up to a power of two so the index can be masked
+        std::size_t size = 1;
+        while(size < capacity)
+                size <<= 1;
+        fBuffer.resize(size);
+        fMask = size - 1;
+}
+
+OutputQueue::~OutputQueue()
+{
+}
+
+void OutputQueue::Push(const OutputRecord& record)
+{
+        std::size_t tail = fTail.load(std::memory_order_relaxed);
+        if(tail - fHead.load(std::memory_order_acquire) > fMask)
+        {
+                ++fStalls;
+                while(tail - fHead.load(std::memory_order_acquire) > fMask)
+                        std::this_thread::yield();
+        }
+        fBuffer[tail & fMask] = record;
+        fTail.store(tail + 1, std::memory_order_release);
+}
+
+G4bool OutputQueue::Pop(OutputRecord& record)
+{
+        std::size_t head = fHead.load(std::memory_order_relaxed);
+        if(head == fTail.load(std::memory_order_acquire))
+                return false;
+        record = fBuffer[head & fMask];
+        fHead.store(head + 1, std::memory_order_release);
+        return true;
+}
@@ -26,12 +26,13 @@
 
 PhysicsListNew::PhysicsListNew(G4bool addNRF_in, G4bool use_xsec_tables_in,
                                G4bool use_xsec_integration_in, G4bool force_isotropic_in,
-                               G4bool standalone_in, G4bool verbose_in)
+                               G4bool standalone_in, G4bool verbose_in, G4bool biasNRF_in)
         : addNRF(addNRF_in), use_xsec_tables(use_xsec_tables_in),
         use_xsec_integration(use_xsec_integration_in),
         force_isotropic(force_isotropic_in),
         standalone(standalone_in),
-        NRF_Verbose(verbose_in)
+        NRF_Verbose(verbose_in),
+        biasNRF(biasNRF_in)
 {
         G4HadronicProcessStore::Instance()->SetVerbose(0);
         ConstructPhysics();
@@ -82,6 +83,15 @@ void PhysicsListNew::ConstructPhysics()
         theNeutronTrackingCut->SetTimeLimit(10*microsecond);
         theNeutronTrackingCut->SetKineticEnergyLimit(0.01*eV);
         RegisterPhysics( theNeutronTrackingCut );
+
+        // Wrap NRF for the forced NRF biasing, registered last so the NRF process already exists
+        if(addNRF && biasNRF)
+        {
+                G4GenericBiasingPhysics* biasingPhysics = new G4GenericBiasingPhysics();
+                biasingPhysics->PhysicsBias("gamma", std::vector<G4String>(1, "NRF"));
+                RegisterPhysics(biasingPhysics);
+                G4cout << "\nAdded NRF Biasing to the physicsList.\n" << G4endl;
+        }
 }
 
 
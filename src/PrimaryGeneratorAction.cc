@@ -23,6 +23,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "PrimaryGeneratorAction.hh"
+#include "PrimaryGeneratorMessenger.hh"
+#include <algorithm>
 
 extern G4long seed;
 extern G4String inFile;
@@ -30,10 +32,23 @@ extern G4double chosen_energy;
 extern G4bool resonanceTest;
 extern G4bool bremTest;
 
-PrimaryGeneratorAction::PrimaryGeneratorAction()
+namespace
+{
+// SplitMix64 finaliser, spreads (seed, eventID) over the whole 64 bit range
+G4long HashSeed(G4long runSeed, G4int eventID)
+{
+        uint64_t z = (uint64_t)runSeed*0x9E3779B97F4A7C15ULL + (uint64_t)eventID + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+        return (G4long)(z ^ (z >> 31));
+}
+}
+
+PrimaryGeneratorAction::PrimaryGeneratorAction(HistoManager* histoAnalysis)
         : G4VUserPrimaryGeneratorAction(),
-        fParticleGun(0)
+        commonRandomNumbers(false), replayEvent(-1), genM(NULL), fParticleGun(0), fHistoManager(histoAnalysis), hBrems(NULL), hSample(NULL), fSampleTable(NULL), fResonanceSource(NULL)
 {
+        genM = new PrimaryGeneratorMessenger(this);
         fParticleGun = new G4ParticleGun(1);
         if(chosen_energy > 0)
                 G4cout << "PrimaryGeneratorAction::Beam Energy > 0" << G4endl;
@@ -56,7 +71,6 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 
         if(chosen_energy < 0)
         {
-                gRandom->SetSeed(seed);
                 if(gSystem->AccessPathName(inFile.c_str()) == 0)
                 {
                         TFile *fin = TFile::Open(inFile.c_str());
@@ -70,6 +84,8 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
                                 if (hBrems && hSample)
                                 {
                                         G4cout << "PrimaryGeneratorAction::Imported brems and sampling distributions from " << fin->GetName() << G4endl << G4endl;
+                                        // sample hSample and weight by hBrems/hSample
+                                        fSampleTable = new AliasTable(hSample, hBrems);
                                 }
 
                                 else
@@ -87,6 +103,7 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
                                 {
                                         G4cout << "PrimaryGeneratorAction::Imported brems distribution from " << fin->GetName() << G4endl;
                                         file_check = true;
+                                        fSampleTable = new AliasTable(hBrems);
                                 }
                                 else
                                 {
@@ -113,20 +130,81 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
         delete fParticleGun;
+        delete genM;
+        delete fSampleTable;
+        delete fResonanceSource;
+}
+
+void PrimaryGeneratorAction::AddResonanceIsotope(G4int Z, G4int A)
+{
+        if(!hBrems)
+        {
+                G4cerr << "ERROR PrimaryGeneratorAction::AddResonanceIsotope -> Resonance sampling requires a bremsstrahlung input spectrum (-i)." << G4endl;
+                return;
+        }
+        if(!fResonanceSource)
+                fResonanceSource = new ResonanceSource(hBrems);
+        fResonanceSource->AddIsotope(Z, A);
+}
+
+void PrimaryGeneratorAction::SetContinuumFraction(G4double val)
+{
+        if(fResonanceSource)
+                fResonanceSource->SetContinuumFraction(val);
+        else
+                G4cerr << "ERROR PrimaryGeneratorAction::SetContinuumFraction -> Add a resonance isotope first." << G4endl;
+}
+
+void PrimaryGeneratorAction::SetResonanceWindow(G4double val)
+{
+        if(fResonanceSource)
+                fResonanceSource->SetWindow(val);
+        else
+                G4cerr << "ERROR PrimaryGeneratorAction::SetResonanceWindow -> Add a resonance isotope first." << G4endl;
+}
+
+void PrimaryGeneratorAction::SeedEvent(G4int eventID)
+{
+        uint64_t h = (uint64_t)HashSeed(seed, eventID);
+        // every sampling goes through the Geant4 engine so one seed determines the whole event.
+        // The full 64 bit hash is passed as two 32 bit words, shifted by one so neither ends the
+        // zero terminated list that engines like Ranecu read
+        long seeds[3];
+        seeds[0] = (long)(h & 0xFFFFFFFFULL) + 1;
+        seeds[1] = (long)(h >> 32) + 1;
+        seeds[2] = 0;
+        CLHEP::HepRandom::setTheSeeds(seeds);
 }
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+        // a resumed run continues the event IDs of the checkpointed run
+        anEvent->SetEventID(anEvent->GetEventID() + fHistoManager->GetEventOffset());
+        // with common random numbers event N of a chopper On and a chopper Off run sees the same random numbers
+        // until the histories diverge in the chopper, so the On - Off difference has a much smaller variance
+        if(replayEvent >= 0)
+        {
+                // the run starts at the replayed event and reproduces it from its event seed
+                anEvent->SetEventID(anEvent->GetEventID() + replayEvent);
+                SeedEvent(anEvent->GetEventID());
+        }
+        else if(commonRandomNumbers)
+                SeedEvent(anEvent->GetEventID());
 
 // Set Particle Energy (Must be in generate primaries)
         //std::cout << "PrimaryGeneratorAction::GeneratePrimaries -> Begin!" << std::endl;
-        if(file_check)
+        G4double w = 1.0;
+        if(fResonanceSource)
+        {
+                energy = fResonanceSource->Sample(w)*MeV; // resonance windows of the NRF level data, w = dNdE/theSampling
+        }
+        else if(file_check)
         {
-                energy = hBrems->GetRandom()*MeV;
+                energy = fSampleTable->Sample(w)*MeV;
         }
         else if(chosen_energy < 0 && !file_check)
         {
-                energy = hSample->GetRandom()*MeV; // sample the resonances specified by hSample
+                energy = fSampleTable->Sample(w)*MeV; // sample the resonances specified by hSample, w = dNdE/theSampling
         }
 
         else if(chosen_energy > 0 && !file_check)
@@ -153,14 +231,6 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
         fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0,0,1)); // along z axis
 
         fParticleGun->GeneratePrimaryVertex(anEvent);
-        G4double w = 1.0;
-
-        if(chosen_energy < 0 && !file_check)
-        {
-                G4double theSampling = hSample->GetBinContent(hSample->GetXaxis()->FindBin(energy));
-                G4double dNdE = hBrems->GetBinContent(hBrems->GetXaxis()->FindBin(energy));
-                w = dNdE/theSampling;
-        }
 
 // Pass the event information
         eventInformation *anInfo = new eventInformation(anEvent);
@@ -171,13 +241,11 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 }
 
 G4double PrimaryGeneratorAction::SampleUResonances() {
-        std::vector<double> er;
-        er.push_back(1.65624253132*MeV);
-        er.push_back(1.7335537285*MeV);
-        er.push_back(1.86232584382*MeV);
+        // fixed U-235 lines for development, use /sampling/resonanceIsotope to sample from the NRF level data
+        static const G4double er[3] = {1.65624253132*MeV, 1.7335537285*MeV, 1.86232584382*MeV};
 
-        G4int idx = Random.Integer(er.size());
+        G4int idx = std::min((G4int)(G4UniformRand()*3), 2);
         G4double de = 25.0*eV;
 
-        return Random.Uniform(er[idx]-de, er[idx]+de);
+        return er[idx] - de + 2.*de*G4UniformRand();
 }
@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PrimaryGeneratorMessenger.hh"
+#include <sstream>
+
+
+PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* genAction)
+        : genA(genAction)
+{
+        myDir = new G4UIdirectory("/sampling/");
+        myDir->SetGuidance("Primary Sampling Commands");
+        CmdCRN = new G4UIcmdWithABool("/sampling/commonRandomNumbers",this);
+        CmdCRN->SetGuidance("Reseed the random engines at the start of every event from the seed and the event ID");
+        CmdCRN->SetGuidance("Chopper On and Off runs with the same seed then share the primaries and the random streams (default false)");
+        CmdCRN->SetParameterName("crn",false);
+        CmdReplay = new G4UIcmdWithAnInteger("/sampling/replayEvent",this);
+        CmdReplay->SetGuidance("Start the following runs at this event ID and reseed every event as with commonRandomNumbers");
+        CmdReplay->SetGuidance("/run/beamOn 1 then reproduces that event of a run made with the same seed and engine (default -1, off)");
+        CmdReplay->SetParameterName("eventID",false);
+        CmdReplay->SetRange("eventID >= -1");
+        CmdResIsotope = new G4UIcmdWithAString("/sampling/resonanceIsotope",this);
+        CmdResIsotope->SetGuidance("Sample the input spectrum around the NRF resonances of this isotope given as Z A, e.g. 92 235");
+        CmdResIsotope->SetGuidance("Repeat for several isotopes. The levels and Doppler widths are read from the G4NRF level data");
+        CmdResIsotope->SetGuidance("and every primary is weighted by the input spectrum over the sampling density");
+        CmdResIsotope->SetParameterName("isotope",false);
+        CmdContinuum = new G4UIcmdWithADouble("/sampling/continuumFraction",this);
+        CmdContinuum->SetGuidance("Fraction of the primaries drawn from the whole input spectrum with resonance sampling (default 0.1)");
+        CmdContinuum->SetParameterName("fraction",false);
+        CmdContinuum->SetRange("fraction >= 0. && fraction <= 1.");
+        CmdResWindow = new G4UIcmdWithADouble("/sampling/resonanceWindow",this);
+        CmdResWindow->SetGuidance("Half width of the sampled window around each resonance in Doppler widths (default 3)");
+        CmdResWindow->SetParameterName("window",false);
+        CmdResWindow->SetRange("window > 0.");
+}
+
+PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
+{
+        delete CmdCRN;
+        delete CmdReplay;
+        delete CmdResIsotope;
+        delete CmdContinuum;
+        delete CmdResWindow;
+        delete myDir;
+}
+
+void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+        if(command == CmdCRN)
+        {
+                G4bool theCRN = CmdCRN->GetNewBoolValue(newValue);
+                genA->SetCommonRandomNumbers(theCRN);
+                G4cout << "Common random numbers set to: " << theCRN << G4endl;
+        }
+        else if(command == CmdReplay)
+        {
+                G4int theEvent = CmdReplay->GetNewIntValue(newValue);
+                genA->SetReplayEvent(theEvent);
+                G4cout << "Replaying from event: " << theEvent << G4endl;
+        }
+        else if(command == CmdResIsotope)
+        {
+                G4int Z = 0, A = 0;
+                std::istringstream is(newValue);
+                is >> Z >> A;
+                if(Z <= 0 || A <= 0)
+                {
+                        G4cerr << "ERROR PrimaryGeneratorMessenger :: /sampling/resonanceIsotope expects Z A, e.g. 92 235." << G4endl;
+                        return;
+                }
+                genA->AddResonanceIsotope(Z, A);
+                G4cout << "Resonance sampling isotope added: Z = " << Z << " A = " << A << G4endl;
+        }
+        else if(command == CmdContinuum)
+        {
+                G4double theFraction = CmdContinuum->GetNewDoubleValue(newValue);
+                genA->SetContinuumFraction(theFraction);
+                G4cout << "Continuum fraction set to: " << theFraction << G4endl;
+        }
+        else if(command == CmdResWindow)
+        {
+                G4double theWindow = CmdResWindow->GetNewDoubleValue(newValue);
+                genA->SetResonanceWindow(theWindow);
+                G4cout << "Resonance window set to: +/- " << theWindow << " Doppler widths" << G4endl;
+        }
+        else
+        {
+                G4cerr << "ERROR PrimaryGeneratorMessenger :: SetNewValue command not found." << G4endl;
+        }
+}
@@ -0,0 +1,239 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RNTupleOutput.hh"
+
+#ifdef MANTIS_RNTUPLE
+
+extern G4bool bremTest;
+extern G4bool checkEvents;
+extern G4long seed;
+
+RNTupleOutput::RNTupleOutput(const G4String& fileName, G4int compressionSettings, G4double clusterSizeMB)
+{
+        fFile = TFile::Open(fileName.c_str(), "RECREATE");
+        if(!fFile || fFile->IsZombie())
+        {
+                G4cerr << "FATAL ERROR RNTupleOutput:: Cannot Open " << fileName << G4endl;
+                exit(1);
+        }
+
+        fOptions.SetCompression(compressionSettings);
+        fOptions.SetApproxZippedClusterSize(static_cast<std::size_t>(clusterSizeMB*1024*1024));
+
+        auto chopInModel = RNT::RNTupleModel::Create();
+        chopInEnergy = chopInModel->MakeField<G4double>("Energy");
+        chopInWeight = chopInModel->MakeField<G4double>("Weight");
+        chopInEventID = chopInModel->MakeField<G4int>("EventID");
+        chopInWriter = MakeWriter(std::move(chopInModel), "ChopIn");
+
+        auto chopOutModel = RNT::RNTupleModel::Create();
+        chopOutEnergy = chopOutModel->MakeField<G4double>("Energy");
+        chopOutWeight = chopOutModel->MakeField<G4double>("Weight");
+        chopOutEventID = chopOutModel->MakeField<G4int>("EventID");
+        chopOutIsNRF = chopOutModel->MakeField<G4int>("isNRF");
+        chopOutWriter = MakeWriter(std::move(chopOutModel), "ChopOut");
+
+        if(bremTest)
+                return;
+
+        auto nrfModel = RNT::RNTupleModel::Create();
+        nrfEventID = nrfModel->MakeField<G4int>("EventID");
+        nrfEnergy = nrfModel->MakeField<G4double>("Energy");
+        nrfWeight = nrfModel->MakeField<G4double>("Weight");
+        nrfMaterial = nrfModel->MakeField<G4int>("Material");
+        nrfZPos = nrfModel->MakeField<G4double>("ZPos");
+        nrfTime = nrfModel->MakeField<G4double>("Time");
+        // run key of the offline EventCheck join, constant over the run
+        nrfSeed = nrfModel->MakeField<G4int>("Seed");
+        *nrfSeed = (G4int)seed;
+        nrfWriter = MakeWriter(std::move(nrfModel), "NRFMatData");
+
+        auto cherModel = RNT::RNTupleModel::Create();
+        cherEnergy = cherModel->MakeField<G4double>("Energy");
+        cherWeight = cherModel->MakeField<G4double>("Weight");
+        cherEventID = cherModel->MakeField<G4int>("EventID");
+        cherSecondaries = cherModel->MakeField<G4int>("NumSecondaries");
+        cherTime = cherModel->MakeField<G4double>("Time");
+        cherTimeMin = cherModel->MakeField<G4double>("TimeMin");
+        cherTimeRMS = cherModel->MakeField<G4double>("TimeRMS");
+        cherSeed = cherModel->MakeField<G4int>("Seed");
+        *cherSeed = (G4int)seed;
+        cherWriter = MakeWriter(std::move(cherModel), "Cherenkov");
+
+        auto detModel = RNT::RNTupleModel::Create();
+        detEventID = detModel->MakeField<G4int>("EventID");
+        detEnergy = detModel->MakeField<G4double>("Energy");
+        detWeight = detModel->MakeField<G4double>("Weight");
+        detCreatorProcess = detModel->MakeField<G4int>("CreatorProcess");
+        detTime = detModel->MakeField<G4double>("Time");
+        detSeed = detModel->MakeField<G4int>("Seed");
+        *detSeed = (G4int)seed;
+        detWriter = MakeWriter(std::move(detModel), "DetInfo");
+
+        auto incDetModel = RNT::RNTupleModel::Create();
+        incDetEventID = incDetModel->MakeField<G4int>("EventID");
+        incDetEnergy = incDetModel->MakeField<G4double>("Energy");
+        incDetWeight = incDetModel->MakeField<G4double>("Weight");
+        incDetProcess = incDetModel->MakeField<G4int>("DetProcess");
+        incDetWriter = MakeWriter(std::move(incDetModel), "IncDetInfo");
+
+        if(!checkEvents)
+                return;
+
+        auto nrfToCherModel = RNT::RNTupleModel::Create();
+        nrfToCherEventID = nrfToCherModel->MakeField<G4int>("EventID");
+        nrfToCherNRFEnergy = nrfToCherModel->MakeField<G4double>("NRF_Energy");
+        nrfToCherNRFWeight = nrfToCherModel->MakeField<G4double>("NRF_Weight");
+        nrfToCherCherEnergy = nrfToCherModel->MakeField<G4double>("Cher_Energy");
+        nrfToCherCherWeight = nrfToCherModel->MakeField<G4double>("Cher_Weight");
+        nrfToCherWriter = MakeWriter(std::move(nrfToCherModel), "nrf_to_cher_tree");
+
+        auto toDetModel = RNT::RNTupleModel::Create();
+        toDetEventID = toDetModel->MakeField<G4int>("EventID");
+        toDetNRFEnergy = toDetModel->MakeField<G4double>("EnergyNRF");
+        toDetCherEnergy = toDetModel->MakeField<G4double>("EnergyCher");
+        toDetNRFWeight = toDetModel->MakeField<G4double>("WeightNRF");
+        toDetCherWeight = toDetModel->MakeField<G4double>("WeightCher");
+        toDetNRFTime = toDetModel->MakeField<G4double>("TimeNRF");
+        toDetCherTime = toDetModel->MakeField<G4double>("TimeCher");
+        nrfToCherToDetWriter = MakeWriter(std::move(toDetModel), "nrf_to_cher_to_det_tree");
+}
+
+RNTupleOutput::~RNTupleOutput()
+{
+        // destroying the writers commits the last clusters and the RNTuple anchors
+        chopInWriter.reset();
+        chopOutWriter.reset();
+        nrfWriter.reset();
+        cherWriter.reset();
+        detWriter.reset();
+        incDetWriter.reset();
+        nrfToCherWriter.reset();
+        nrfToCherToDetWriter.reset();
+        fFile->Close();
+        delete fFile;
+}
+
+std::unique_ptr<RNT::RNTupleWriter> RNTupleOutput::MakeWriter(std::unique_ptr<RNT::RNTupleModel> model, const char* name)
+{
+        return RNT::RNTupleWriter::Append(std::move(model), name, *fFile, fOptions);
+}
+
+void RNTupleOutput::FillChopIn(G4int eventID, G4double energy, G4double weight)
+{
+        *chopInEnergy = energy;
+        *chopInWeight = weight;
+        *chopInEventID = eventID;
+        chopInWriter->Fill();
+}
+
+void RNTupleOutput::FillChopOut(G4int eventID, G4double energy, G4double weight, G4int isNRF)
+{
+        *chopOutEnergy = energy;
+        *chopOutWeight = weight;
+        *chopOutEventID = eventID;
+        *chopOutIsNRF = isNRF;
+        chopOutWriter->Fill();
+}
+
+void RNTupleOutput::FillNRF(G4int eventID, G4double energy, G4double weight, G4int material, G4double zPos, G4double time)
+{
+        // not booked in bremTest, same as the TTree ntuples
+        if(!nrfWriter)
+                return;
+        *nrfEventID = eventID;
+        *nrfEnergy = energy;
+        *nrfWeight = weight;
+        *nrfMaterial = material;
+        *nrfZPos = zPos;
+        *nrfTime = time;
+        nrfWriter->Fill();
+}
+
+void RNTupleOutput::FillCherenkov(G4int eventID, G4double energy, G4double weight, G4int secondaries, G4double time,
+                                  G4double timeMin, G4double timeRMS)
+{
+        if(!cherWriter)
+                return;
+        *cherEnergy = energy;
+        *cherWeight = weight;
+        *cherEventID = eventID;
+        *cherSecondaries = secondaries;
+        *cherTime = time;
+        *cherTimeMin = timeMin;
+        *cherTimeRMS = timeRMS;
+        cherWriter->Fill();
+}
+
+void RNTupleOutput::FillDet(G4int eventID, G4double energy, G4double weight, G4int creatorProcess, G4double time)
+{
+        if(!detWriter)
+                return;
+        *detEventID = eventID;
+        *detEnergy = energy;
+        *detWeight = weight;
+        *detCreatorProcess = creatorProcess;
+        *detTime = time;
+        detWriter->Fill();
+}
+
+void RNTupleOutput::FillIncDet(G4int eventID, G4double energy, G4double weight, G4int detProcess)
+{
+        if(!incDetWriter)
+                return;
+        *incDetEventID = eventID;
+        *incDetEnergy = energy;
+        *incDetWeight = weight;
+        *incDetProcess = detProcess;
+        incDetWriter->Fill();
+}
+
+void RNTupleOutput::FillNRFToCher(G4int eventID, G4double nrfE, G4double nrfW, G4double cherE, G4double cherW)
+{
+        if(!nrfToCherWriter)
+                return;
+        *nrfToCherEventID = eventID;
+        *nrfToCherNRFEnergy = nrfE;
+        *nrfToCherNRFWeight = nrfW;
+        *nrfToCherCherEnergy = cherE;
+        *nrfToCherCherWeight = cherW;
+        nrfToCherWriter->Fill();
+}
+
+void RNTupleOutput::FillNRFToCherToDet(G4int eventID, G4double nrfE, G4double nrfW, G4double cherE, G4double cherW, G4double nrfTime, G4double detTime)
+{
+        if(!nrfToCherToDetWriter)
+                return;
+        *toDetEventID = eventID;
+        *toDetNRFEnergy = nrfE;
+        *toDetCherEnergy = cherE;
+        *toDetNRFWeight = nrfW;
+        *toDetCherWeight = cherW;
+        *toDetNRFTime = nrfTime;
+        *toDetCherTime = detTime;
+        nrfToCherToDetWriter->Fill();
+}
+
+#endif // MANTIS_RNTUPLE
@@ -0,0 +1,190 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ResonanceSource.hh"
+#include "G4NRFNuclearLevelStore.hh"
+#include "G4NRFNuclearLevelManager.hh"
+#include "G4NRFNuclearLevel.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+ResonanceSource::ResonanceSource(const TH1D* brems)
+        : fBrems(brems), fContinuum(NULL), bremsTotal(0.), continuumFraction(0.1), window(3.),
+        initialized(false), windowNorm(1.)
+{
+        fContinuum = new AliasTable(brems);
+        for(G4int i=1; i<=brems->GetNbinsX(); ++i)
+                bremsTotal += std::max(brems->GetBinContent(i), 0.);
+}
+
+ResonanceSource::~ResonanceSource()
+{
+        delete fContinuum;
+}
+
+void ResonanceSource::AddIsotope(G4int Z, G4int A)
+{
+        for(unsigned int i=0; i<isoZ.size(); ++i)
+        {
+                if(isoZ[i] == Z && isoA[i] == A)
+                        return;
+        }
+        isoZ.push_back(Z);
+        isoA.push_back(A);
+        // the level table is rebuilt with the new isotope at the next draw
+        initialized = false;
+}
+
+void ResonanceSource::Initialize()
+{
+        lineEnergy.clear();
+        lineDelta.clear();
+        lineProb.clear();
+        lineCumulative.clear();
+
+        const G4double Emin = fBrems->GetXaxis()->GetXmin()*MeV;
+        const G4double Emax = fBrems->GetXaxis()->GetXmax()*MeV;
+        G4double total = 0.;
+
+        G4cout << "ResonanceSource::Initialize -> Resonances between " << Emin/MeV << " and " << Emax/MeV << " MeV" << G4endl;
+        G4cout << std::setw(6) << "Z" << std::setw(6) << "A" << std::setw(18) << "E_r [MeV]"
+               << std::setw(16) << "Delta [eV]" << std::setw(16) << "Gamma0 [eV]" << G4endl;
+        for(unsigned int i=0; i<isoZ.size(); ++i)
+        {
+                G4NRFNuclearLevelManager* pManager = G4NRFNuclearLevelStore::GetInstance()->GetManager(isoZ[i], isoA[i]);
+                if(!pManager || pManager->NumberOfLevels() == 0)
+                {
+                        G4cerr << "ERROR ResonanceSource::Initialize -> No NRF levels found for Z = " << isoZ[i]
+                               << " A = " << isoA[i] << G4endl;
+                        continue;
+                }
+
+                // same Doppler broadening as G4NRF::NRF_xsec_calc, 300 K if the effective temperature is unknown
+                const G4double M = isoA[i]*amu_c2;
+                const G4double T_eff_tmp = pManager->GetTeff();
+                const G4double T_eff = (T_eff_tmp > 0 ? T_eff_tmp : 300*kelvin);
+                const G4double J0 = pManager->GetGroundStateSpin();
+
+                const G4NRFPtrLevelVector* levels = pManager->GetLevels();
+                for(unsigned int j=0; j<levels->size(); ++j)
+                {
+                        const G4NRFNuclearLevel* pLevel = (*levels)[j];
+                        const G4double Gamma_0r = pLevel->Width0();
+                        if(Gamma_0r <= 0.)
+                                continue;
+
+                        const G4double E1 = pLevel->Energy();
+                        const G4double E_r = E1 + E1*E1/M/2.0;
+                        if(E_r <= Emin || E_r >= Emax)
+                                continue;
+                        const G4double Delta_eff = E_r*sqrt(2.0*k_Boltzmann*T_eff/M);
+
+                        // proportional to the flux at the resonance times the integrated absorption cross section
+                        const G4double stat_fac = (2.0*pLevel->AngularMomentum() + 1.0)/(2.0*J0 + 1.0);
+                        const G4double p = BremsDensity(E_r/MeV)*stat_fac*Gamma_0r/E_r/E_r;
+                        if(p <= 0.)
+                                continue;
+
+                        lineEnergy.push_back(E_r/MeV);
+                        lineDelta.push_back(Delta_eff/MeV);
+                        lineProb.push_back(p);
+                        total += p;
+                        G4cout << std::setw(6) << isoZ[i] << std::setw(6) << isoA[i] << std::setw(18) << std::setprecision(10) << E_r/MeV
+                               << std::setw(16) << std::setprecision(4) << Delta_eff/eV << std::setw(16) << Gamma_0r/eV << G4endl;
+                }
+        }
+        G4cout << std::setprecision(6);
+
+        if(lineEnergy.empty())
+        {
+                G4cerr << "FATAL ERROR ResonanceSource::Initialize -> No resonances inside the bremsstrahlung spectrum!" << G4endl;
+                exit(1);
+        }
+
+        G4double sum = 0.;
+        for(unsigned int k=0; k<lineProb.size(); ++k)
+        {
+                lineProb[k] /= total;
+                sum += lineProb[k];
+                lineCumulative.push_back(sum);
+        }
+        windowNorm = std::erf(window);
+        initialized = true;
+        G4cout << "ResonanceSource::Initialize -> Sampling " << lineEnergy.size() << " resonances in windows of +/- "
+               << window << " Doppler widths, continuum fraction " << continuumFraction << G4endl;
+}
+
+G4double ResonanceSource::BremsDensity(G4double e) const
+{
+        G4int bin = fBrems->GetXaxis()->FindBin(e);
+        if(bin < 1 || bin > fBrems->GetNbinsX())
+                return 0.;
+        return std::max(fBrems->GetBinContent(bin), 0.)/bremsTotal/fBrems->GetXaxis()->GetBinWidth(bin);
+}
+
+G4double ResonanceSource::WindowDensity(G4double e) const
+{
+        // each window is a Gaussian exp(-((e - E_r)/Delta)^2) cut at +/- window Doppler widths
+        G4double density = 0.;
+        for(unsigned int k=0; k<lineEnergy.size(); ++k)
+        {
+                G4double x = (e - lineEnergy[k])/lineDelta[k];
+                if(std::fabs(x) < window)
+                        density += lineProb[k]*exp(-x*x)/(sqrt(pi)*lineDelta[k]*windowNorm);
+        }
+        return density;
+}
+
+G4double ResonanceSource::Sample(G4double& weight)
+{
+        if(!initialized)
+                Initialize();
+
+        G4double e;
+        if(G4UniformRand() < continuumFraction)
+        {
+                G4double w;
+                e = fContinuum->Sample(w);
+        }
+        else
+        {
+                G4int k = std::upper_bound(lineCumulative.begin(), lineCumulative.end(), G4UniformRand()*lineCumulative.back())
+                          - lineCumulative.begin();
+                k = std::min(k, (G4int) lineEnergy.size() - 1);
+                // standard deviation Delta/sqrt(2), redrawn until it falls inside the window
+                G4double x;
+                do
+                {
+                        x = G4RandGauss::shoot(0., 1./sqrt(2.));
+                } while(std::fabs(x) >= window);
+                e = lineEnergy[k] + x*lineDelta[k];
+        }
+
+        G4double q = continuumFraction*BremsDensity(e) + (1. - continuumFraction)*WindowDensity(e);
+        weight = q > 0. ? BremsDensity(e)/q : 0.;
+        return e;
+}
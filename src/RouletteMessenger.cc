@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RouletteMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include <sstream>
+
+RouletteMessenger::RouletteMessenger(RouletteRules* rules)
+        : rouletteR(rules)
+{
+        myDir = new G4UIdirectory("/roulette/");
+        myDir->SetGuidance("Russian Roulette Commands");
+        CmdRule = new G4UIcmdWithAString("/roulette/rule",this);
+        CmdRule->SetGuidance("Add a Russian roulette rule: volume Emax[MeV] survival [particle=gamma (or all)]");
+        CmdRule->SetGuidance("Tracks of the particle below Emax in volumes whose name starts with volume (e.g. Container, hollowContainer, Attenuator)");
+        CmdRule->SetGuidance("survive with probability survival and their weight is divided by it. The first matching rule applies.");
+        CmdRule->SetParameterName("rule",false);
+        CmdWindow = new G4UIcmdWithAString("/roulette/window",this);
+        CmdWindow->SetGuidance("Add a weight window: volume Emax[MeV] wLow wHigh [particle=gamma (or all)]");
+        CmdWindow->SetGuidance("Tracks of the particle below Emax in volumes whose name starts with volume and a weight below wLow");
+        CmdWindow->SetGuidance("survive at the window centre weight, tracks entering such a volume above wHigh are split. wHigh >= 2 wLow.");
+        CmdWindow->SetParameterName("window",false);
+        CmdClear = new G4UIcmdWithoutParameter("/roulette/clear",this);
+        CmdClear->SetGuidance("Remove all Russian roulette rules and weight windows");
+}
+
+RouletteMessenger::~RouletteMessenger()
+{
+        delete CmdRule;
+        delete CmdWindow;
+        delete CmdClear;
+        delete myDir;
+}
+
+void RouletteMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+        if(command == CmdRule)
+        {
+                G4String volume, particle = "gamma";
+                G4double Emax = -1., survival = -1.;
+                std::istringstream is(newValue);
+                is >> volume >> Emax >> survival;
+                if(!(is >> particle))
+                        particle = "gamma";
+                if(volume == "" || Emax <= 0. || survival <= 0. || survival > 1.)
+                {
+                        G4cerr << "ERROR RouletteMessenger :: /roulette/rule expects volume Emax[MeV] survival (0 < survival <= 1) [particle]." << G4endl;
+                        return;
+                }
+                rouletteR->AddRule(volume, Emax*MeV, survival, particle);
+                rouletteR->Print();
+        }
+        else if(command == CmdWindow)
+        {
+                G4String volume, particle = "gamma";
+                G4double Emax = -1., wLow = -1., wHigh = -1.;
+                std::istringstream is(newValue);
+                is >> volume >> Emax >> wLow >> wHigh;
+                if(!(is >> particle))
+                        particle = "gamma";
+                // split copies of a track above wHigh keep at least wHigh/2 and are not rouletted again
+                if(volume == "" || Emax <= 0. || wLow <= 0. || wHigh < 2.*wLow)
+                {
+                        G4cerr << "ERROR RouletteMessenger :: /roulette/window expects volume Emax[MeV] wLow wHigh (0 < 2 wLow <= wHigh) [particle]." << G4endl;
+                        return;
+                }
+                rouletteR->AddWindow(volume, Emax*MeV, wLow, wHigh, particle);
+                rouletteR->Print();
+        }
+        else if(command == CmdClear)
+        {
+                rouletteR->Clear();
+                G4cout << "Russian roulette rules and weight windows cleared." << G4endl;
+        }
+        else
+        {
+                G4cerr << "ERROR RouletteMessenger :: SetNewValue command not found." << G4endl;
+        }
+}
@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RouletteRules.hh"
+#include "RouletteMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cmath>
+
+// a track above a weight window is split into at most this many copies per volume
+static const G4int kMaxSplit = 10;
+
+RouletteRules::RouletteRules()
+        : rouletteM(NULL)
+{
+        rouletteM = new RouletteMessenger(this);
+}
+
+RouletteRules::~RouletteRules()
+{
+        delete rouletteM;
+}
+
+void RouletteRules::AddRule(G4String volume, G4double Emax, G4double survival, G4String particle)
+{
+        Rule rule;
+        rule.volume = volume;
+        rule.particle = particle;
+        rule.Emax = Emax;
+        rule.survival = survival;
+        rules.push_back(rule);
+}
+
+void RouletteRules::AddWindow(G4String volume, G4double Emax, G4double wLow, G4double wHigh, G4String particle)
+{
+        Window window;
+        window.volume = volume;
+        window.particle = particle;
+        window.Emax = Emax;
+        window.wLow = wLow;
+        window.wHigh = wHigh;
+        windows.push_back(window);
+}
+
+void RouletteRules::Clear()
+{
+        rules.clear();
+        windows.clear();
+}
+
+void RouletteRules::Print() const
+{
+        G4cout << "RouletteRules::Print -> " << rules.size() << " Russian roulette rules" << G4endl;
+        for(unsigned int i=0; i<rules.size(); ++i)
+                G4cout << "  " << rules[i].particle << " below " << rules[i].Emax/(MeV) << " MeV in " << rules[i].volume
+                       << "* survives with probability " << rules[i].survival << G4endl;
+        G4cout << "RouletteRules::Print -> " << windows.size() << " weight windows" << G4endl;
+        for(unsigned int i=0; i<windows.size(); ++i)
+                G4cout << "  " << windows[i].particle << " below " << windows[i].Emax/(MeV) << " MeV in " << windows[i].volume
+                       << "* weight window [" << windows[i].wLow << ", " << windows[i].wHigh << "]" << G4endl;
+}
+
+const RouletteRules::Window* RouletteRules::FindWindow(const G4Track* track, const G4String& volumeName) const
+{
+        const G4String& particleName = track->GetDefinition()->GetParticleName();
+        G4double energy = track->GetKineticEnergy();
+        for(unsigned int i=0; i<windows.size(); ++i)
+        {
+                const Window& window = windows[i];
+                if(volumeName.compare(0, window.volume.size(), window.volume) != 0)
+                        continue;
+                if(window.particle != "all" && window.particle != particleName)
+                        continue;
+                if(energy >= window.Emax)
+                        continue;
+                return &window;
+        }
+        return NULL;
+}
+
+G4bool RouletteRules::Apply(G4Track* track, const G4String& volumeName) const
+{
+        const G4String& particleName = track->GetDefinition()->GetParticleName();
+        G4double energy = track->GetKineticEnergy();
+        // the first matching rule decides
+        for(unsigned int i=0; i<rules.size(); ++i)
+        {
+                const Rule& rule = rules[i];
+                if(volumeName.compare(0, rule.volume.size(), rule.volume) != 0)
+                        continue;
+                if(rule.particle != "all" && rule.particle != particleName)
+                        continue;
+                if(energy >= rule.Emax)
+                        continue;
+
+                if(G4UniformRand() >= rule.survival)
+                        return true;
+                track->SetWeight(track->GetWeight()/rule.survival);
+                return false;
+        }
+        // no rule matched, tracks below the weight window survive at the window centre
+        const Window* window = FindWindow(track, volumeName);
+        if(!window || track->GetWeight() >= window->wLow)
+                return false;
+        G4double survivalWeight = 0.5*(window->wLow + window->wHigh);
+        if(G4UniformRand()*survivalWeight >= track->GetWeight())
+                return true;
+        track->SetWeight(survivalWeight);
+        return false;
+}
+
+G4int RouletteRules::Split(const G4Track* track, const G4String& volumeName) const
+{
+        // the rules take precedence over the windows, as in Apply
+        const G4String& particleName = track->GetDefinition()->GetParticleName();
+        for(unsigned int i=0; i<rules.size(); ++i)
+        {
+                const Rule& rule = rules[i];
+                if(volumeName.compare(0, rule.volume.size(), rule.volume) == 0
+                   && (rule.particle == "all" || rule.particle == particleName) && track->GetKineticEnergy() < rule.Emax)
+                        return 1;
+        }
+        const Window* window = FindWindow(track, volumeName);
+        if(!window || track->GetWeight() <= window->wHigh)
+                return 1;
+        return std::min((G4int)std::ceil(track->GetWeight()/window->wHigh), kMaxSplit);
+}
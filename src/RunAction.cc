@@ -49,11 +49,17 @@ void RunAction::BeginOfRunAction(const G4Run*)
         fScintEnergy = 0;
         fNRF = 0;
         fStatusKilled = 0;
+        fEarlyAbort = 0;
+        fOpticalCut = 0;
+        fEarlyAbortWeight = 0.;
         G4cout << G4endl << "Beginning Run..." << G4endl;
 }
 
 void RunAction::EndOfRunAction(const G4Run* aRun)
 {
+        // a resumed run that was already complete wrote nothing
+        if(output && fHistoManager->IsComplete())
+                return;
         G4int TotNbofEvents = aRun->GetNumberOfEvent();
         std::ios::fmtflags mode = G4cout.flags();
         G4int prec = G4cout.precision(2);
@@ -66,6 +72,13 @@ void RunAction::EndOfRunAction(const G4Run* aRun)
         G4cout << "Total number of Scintillation Photons:                 " << fScintCount << G4endl;
         G4cout << "Total number of Optical Photons:                       " << fCerenkovCount + fScintCount << G4endl;
         G4cout << "Total number of Tracks Cut Based on Position:          " << fStatusKilled << G4endl;
+        if(fOpticalCut > 0)
+                G4cout << "Total number of Optical Photons Cut by the Event Caps: " << fOpticalCut << G4endl;
+        if(fEarlyAbort > 0)
+        {
+                G4cout << "Total number of Events Ended Before the Water Tanks:   " << fEarlyAbort << G4endl;
+                G4cout << " Summed weight of the ended Events:                  " << fEarlyAbortWeight << G4endl;
+        }
         G4cout << "Average total energy of Cherenkov photons per event:   "
                << (fCerenkovEnergy/eV)/TotNbofEvents << " eV." << G4endl;
         G4cout << "Average number of Cherenkov photons created per event: "
@@ -93,14 +106,10 @@ void RunAction::EndOfRunAction(const G4Run* aRun)
         {
                 fHistoManager->finish();
         }
-        if(checkEvents)
-        {
-                EventCheck *eCheck = new EventCheck();
-                eCheck->WriteEvents();
-        }
+        // with checkEvents the event correlations are written by EventAction during the run
         if(weightHisto && checkEvents && output)
         {
-                WeightHisto *wHisto = new WeightHisto(fHistoManager->GetEmax());
+                WeightHisto *wHisto = new WeightHisto(fHistoManager->GetEmax(), fHistoManager->GetBinEdges(), fHistoManager->GetAnalysisThreads());
                 wHisto->Fill_NRF_to_Cherenkov();
                 wHisto->Fill_to_Det();
         }
@@ -23,19 +23,152 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "StackingAction.hh"
+#include "OpticalMessenger.hh"
+#include "StackingMessenger.hh"
+#include "OutputCodes.hh"
+#include "eventInformation.hh"
+#include "G4RunManager.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4AffineTransform.hh"
+#include "Randomize.hh"
+#include "trackInformation.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4OpticalSurface.hh"
+#include "G4MaterialPropertiesTable.hh"
 
 
-StackingAction::StackingAction(const DetectorConstruction* det, RunAction* run)
-        : local_det(det), local_run(run)
+StackingAction::StackingAction(const DetectorConstruction* det, RunAction* run, EventAction* event, HistoManager* histo, RouletteRules* roulette)
+        : local_det(det), local_run(run), local_roulette(roulette), local_event(event), local_histo(histo),
+        fOpticalMap(NULL), opticalThinning(1), qePreSampling(false), fQE(NULL), opticalM(NULL), stackM(NULL),
+        earlyAbortEnergy(0.), deferOptical(false), tankReached(false), stage(0),
+        maxPE(0), maxOpticalTracks(0), nOpticalTracks(0), nSaturated(0), timeGate(0.)
 {
+        opticalM = new OpticalMessenger(this);
+        stackM = new StackingMessenger(this);
 }
 
 StackingAction::~StackingAction()
 {
+        delete local_roulette;
+        delete fOpticalMap;
+        delete opticalM;
+        delete stackM;
+}
+
+G4bool StackingAction::SetOpticalMap(G4String fileName)
+{
+        delete fOpticalMap;
+        fOpticalMap = NULL;
+        if(fileName == "none")
+                return true;
+
+        OpticalResponseMap* theMap = new OpticalResponseMap();
+        if(!theMap->Load(fileName))
+        {
+                delete theMap;
+                return false;
+        }
+        if(theMap->GetSignature() != local_det->GetOpticalSignature())
+        {
+                G4cerr << "ERROR StackingAction::SetOpticalMap -> " << fileName << " was made for " << theMap->GetSignature()
+                       << " but the water tank is " << local_det->GetOpticalSignature() << ". Optical photons are tracked." << G4endl;
+                delete theMap;
+                return false;
+        }
+        fOpticalMap = theMap;
+        return true;
+}
+
+G4MaterialPropertyVector* StackingAction::FindQE() const
+{
+        G4LogicalVolume* logicPC = G4LogicalVolumeStore::GetInstance()->GetVolume("PC", false);
+        G4LogicalSkinSurface* skin = logicPC ? G4LogicalSkinSurface::GetSurface(logicPC) : NULL;
+        G4OpticalSurface* surface = skin ? dynamic_cast<G4OpticalSurface*>(skin->GetSurfaceProperty()) : NULL;
+        G4MaterialPropertiesTable* table = surface ? surface->GetMaterialPropertiesTable() : NULL;
+        return table ? table->GetProperty("EFFICIENCY") : NULL;
+}
+
+void StackingAction::PrepareNewEvent()
+{
+        stage = 0;
+        tankReached = false;
+        nOpticalTracks = 0;
+        nSaturated = 0;
+        peCount.assign(2*local_det->GetnPMT(), 0);
+        // looked up every event, the photocathode is rebuilt with the geometry
+        fQE = NULL;
+        if(qePreSampling)
+        {
+                fQE = FindQE();
+                if(!fQE)
+                        G4cerr << "ERROR StackingAction::PrepareNewEvent -> No photocathode EFFICIENCY found, QE pre-sampling is off." << G4endl;
+        }
+}
+
+G4int StackingAction::GetPMTIndex(const G4VTouchable* touchable, G4int pmt) const
+{
+        // the tanks are the 1LayL and 1LayR placements in the world
+        G4int tank = 0;
+        for(G4int depth=0; depth<touchable->GetHistoryDepth(); ++depth)
+                if(touchable->GetVolume(depth)->GetName() == "1LayR")
+                        tank = 1;
+        return tank*local_det->GetnPMT() + pmt - 1;
+}
+
+G4bool StackingAction::AcceptDetection(const G4VTouchable* touchable, G4int pmt)
+{
+        if(maxPE <= 0)
+                return true;
+        G4int i = GetPMTIndex(touchable, pmt);
+        if(i < 0 || i >= (G4int)peCount.size())
+                return true;
+        if(peCount[i] >= maxPE)
+                return false;
+        if(++peCount[i] == maxPE)
+                ++nSaturated;
+        return true;
+}
+
+void StackingAction::NewStage()
+{
+        // the waiting tracks are already in the urgent stack here
+        ++stage;
+        if(stage == 1 && earlyAbortEnergy > 0. && !tankReached)
+        {
+                // nothing energetic enough reached the water tanks, the rest of the event cannot be detected
+                const G4Event* anEvent = G4RunManager::GetRunManager()->GetCurrentEvent();
+                eventInformation* info = (eventInformation*)(anEvent->GetUserInformation());
+                local_run->AddEarlyAbort(info->GetWeight());
+                stackManager->clear();
+        }
+}
+
+void StackingAction::FillDetected(const G4Track* aTrack, G4double time)
+{
+        const G4Event* anEvent = G4RunManager::GetRunManager()->GetCurrentEvent();
+        eventInformation* info = (eventInformation*)(anEvent->GetUserInformation());
+        G4double weight = info->GetWeight(aTrack);
+        const G4VProcess* creator = aTrack->GetCreatorProcess();
+        // creator process code 0 is the beam ("Brem"), time units is nanoseconds
+        local_histo->FillDet(anEvent->GetEventID(), aTrack->GetKineticEnergy()/(MeV), weight,
+                             OutputCodes::GetProcessCode(creator), time);
+        local_histo->FillH1(11, aTrack->GetKineticEnergy()/(eV), weight);
+        if(creator && (creator->GetProcessName() == "Cerenkov" || creator->GetProcessName() == "Scintillation"))
+                local_event->DetectedEvent(time);
 }
 
 G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* currentTrack)
 {
+        // suspended by SteppingAction when entering a water tank in the first stage
+        if(currentTrack->GetTrackStatus() == fSuspend)
+        {
+                if(currentTrack->GetKineticEnergy() >= earlyAbortEnergy)
+                        tankReached = true;
+                return fWaiting;
+        }
         // if a new track is created beyond interogation material kill it
         G4double EndIntObj = local_det->getEndIntObj();
         G4double trackZ = currentTrack->GetPosition().z();
@@ -47,5 +180,72 @@ G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* curre
         G4ParticleDefinition *pdef = currentTrack->GetDefinition();
         // kill neutrons (probably not important)
         if(pdef == G4Neutron::Definition()) return fKill;
+        // Russian roulette of secondaries created in a low importance volume, primaries have no volume yet
+        if(local_roulette->HasRules() && currentTrack->GetVolume())
+        {
+                if(local_roulette->Apply(const_cast<G4Track*>(currentTrack), currentTrack->GetVolume()->GetName()))
+                {
+                        local_run->AddStatusKilled();
+                        return fKill;
+                }
+        }
+        // Cherenkov thinning, the weight of the kept photons goes into DetInfo through eventInformation::GetWeight
+        if(opticalThinning > 1 && pdef == G4OpticalPhoton::Definition())
+        {
+                if(G4UniformRand()*opticalThinning >= 1.)
+                        return fKill;
+                const_cast<G4Track*>(currentTrack)->SetWeight(currentTrack->GetWeight()*opticalThinning);
+        }
+        // Per event caps: no optical photons once every PMT is saturated or after the time gate
+        if(pdef == G4OpticalPhoton::Definition())
+        {
+                if((maxPE > 0 && nSaturated >= (G4int)peCount.size())
+                   || (timeGate > 0. && local_event->HasDetection()
+                       && currentTrack->GetGlobalTime() > local_event->GetDetectionTime() + timeGate))
+                {
+                        local_run->AddOpticalCut();
+                        return fKill;
+                }
+        }
+        // Fast optical response: the map decides at creation if and when the photon is detected,
+        // photons outside the map are tracked normally
+        if(fOpticalMap && pdef == G4OpticalPhoton::Definition()
+           && currentTrack->GetVolume() && currentTrack->GetVolume()->GetName() == "Water")
+        {
+                const G4AffineTransform& transform = currentTrack->GetTouchable()->GetHistory()->GetTopTransform();
+                G4ThreeVector localPos = transform.TransformPoint(currentTrack->GetPosition());
+                G4ThreeVector localDir = transform.TransformAxis(currentTrack->GetMomentumDirection());
+                if(fOpticalMap->GetBin(localPos, localDir, currentTrack->GetKineticEnergy()) >= 0)
+                {
+                        G4double delay = 0.;
+                        G4int pmt = fOpticalMap->Sample(localPos, localDir, currentTrack->GetKineticEnergy(), delay);
+                        if(pmt >= 0 && AcceptDetection(currentTrack->GetTouchable(), pmt + 1))
+                                FillDetected(currentTrack, currentTrack->GetGlobalTime() + delay);
+                        return fKill;
+                }
+        }
+        // QE pre-sampling: photons failing the photocathode efficiency are never tracked, the survivors are
+        // marked so SteppingAction counts their photocathode absorption as a detection
+        if(fQE && pdef == G4OpticalPhoton::Definition())
+        {
+                if(G4UniformRand() >= fQE->Value(currentTrack->GetKineticEnergy()))
+                        return fKill;
+                trackInformation* info = new trackInformation();
+                info->SetPreAccepted(true);
+                const_cast<G4Track*>(currentTrack)->SetUserInformation(info);
+        }
+        // at most maxOpticalTracks optical photons are tracked per event
+        if(maxOpticalTracks > 0 && pdef == G4OpticalPhoton::Definition())
+        {
+                if(nOpticalTracks >= maxOpticalTracks)
+                {
+                        local_run->AddOpticalCut();
+                        return fKill;
+                }
+                ++nOpticalTracks;
+        }
+        // optical photons wait until the water tank tracks are done
+        if(deferOptical && pdef == G4OpticalPhoton::Definition() && stage < (earlyAbortEnergy > 0. ? 2 : 1))
+                return fWaiting;
         return fUrgent;
 }
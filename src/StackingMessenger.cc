@@ -0,0 +1,68 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StackingMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+StackingMessenger::StackingMessenger(StackingAction* stackAction)
+        : stackA(stackAction)
+{
+        myDir = new G4UIdirectory("/stacking/");
+        myDir->SetGuidance("Track Stacking Commands");
+        CmdEarlyAbort = new G4UIcmdWithADouble("/stacking/earlyAbort",this);
+        CmdEarlyAbort->SetGuidance("Tracks entering a water tank wait until the rest of the event is tracked. If none of them has at least");
+        CmdEarlyAbort->SetGuidance("this energy in MeV the event ends there and its weight is added to the run summary. 0 (default) turns it off");
+        CmdEarlyAbort->SetParameterName("earlyAbort",false);
+        CmdEarlyAbort->SetRange("earlyAbort >= 0.");
+        CmdDeferOptical = new G4UIcmdWithABool("/stacking/deferOptical",this);
+        CmdDeferOptical->SetGuidance("Track the optical photons after all other tracks of the event (default false)");
+        CmdDeferOptical->SetParameterName("deferOptical",false);
+}
+
+StackingMessenger::~StackingMessenger()
+{
+        delete CmdEarlyAbort;
+        delete CmdDeferOptical;
+        delete myDir;
+}
+
+void StackingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+        if(command == CmdEarlyAbort)
+        {
+                G4double theCommand = CmdEarlyAbort->GetNewDoubleValue(newValue);
+                stackA->SetEarlyAbortEnergy(theCommand*MeV);
+                G4cout << "Early event abort energy set to: " << theCommand << " MeV" << G4endl;
+        }
+        else if(command == CmdDeferOptical)
+        {
+                G4bool theCommand = CmdDeferOptical->GetNewBoolValue(newValue);
+                stackA->SetDeferOptical(theCommand);
+                G4cout << "Deferred optical photon stage set to: " << theCommand << G4endl;
+        }
+        else
+        {
+                G4cerr << "ERROR StackingMessenger :: SetNewValue command not found." << G4endl;
+        }
+}
@@ -26,8 +26,9 @@
 extern G4bool bremTest;
 extern G4bool weightHisto;
 
-SteppingAction::SteppingAction(const DetectorConstruction* det, RunAction* run, EventAction* event)
-        : G4UserSteppingAction(), kdet(det), krun(run), kevent(event),
+SteppingAction::SteppingAction(const DetectorConstruction* det, RunAction* run, EventAction* event, HistoManager* histo, const RouletteRules* roulette,
+                               StackingAction* stacking)
+        : G4UserSteppingAction(), kdet(det), krun(run), kevent(event), khisto(histo), kroulette(roulette), kstacking(stacking),
         drawChopperIncDataFlag(0), drawChopperOutDataFlag(0), drawNRFDataFlag(0),
         drawIntObjDataFlag(0), drawWaterIncDataFlag(0), drawCherenkovDataFlag(0), drawDetDataFlag(0),
         stepM(NULL)
@@ -94,13 +95,36 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                 krun->AddStatusKilled();
         }
 
+        // Russian roulette of low importance tracks entering a volume
+        G4int nSplit = 1;
+        if(kroulette->HasRules() && theTrack->GetTrackStatus() != fStopAndKill
+           && nextStep_VolumeName != previousStep_VolumeName)
+        {
+                if(kroulette->Apply(theTrack, nextStep_VolumeName))
+                {
+                        theTrack->SetTrackStatus(fStopAndKill);
+                        krun->AddStatusKilled();
+                        return;
+                }
+                // weight window splitting, the copies are made at the end of the step
+                nSplit = kroulette->Split(theTrack, nextStep_VolumeName);
+                if(nSplit > 1)
+                        theTrack->SetWeight(theTrack->GetWeight()/nSplit);
+        }
+
+        // Staged stacking, tracks entering a water tank wait until the rest of the event is done
+        if(kstacking->SuspendAtTanks() && theTrack->GetTrackStatus() == fAlive
+           && nextStep_VolumeName.compare(0,4,"1Lay") == 0 && previousStep_VolumeName.compare(0,4,"1Lay") != 0)
+        {
+                theTrack->SetTrackStatus(fSuspend);
+        }
+
 // ************************************************* Checks and Cuts Complete ************************************************** //
 
         G4int isNRF = 0;
-        // Grab Weights from PrimaryGenerator
+        // Grab Weights from PrimaryGenerator and the biasing
         eventInformation* info = (eventInformation*)(G4RunManager::GetRunManager()->GetCurrentEvent()->GetUserInformation());
-        weight = info->GetWeight();
-        G4AnalysisManager* manager = G4AnalysisManager::Instance();
+        weight = info->GetWeight(theTrack);
 
 // **************************************************** Track NRF Materials **************************************************** //
 
@@ -111,16 +135,13 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                 if(process->GetProcessName() == "NRF")
                 {
                         krun->AddNRF();
-                        manager->FillNtupleIColumn(2,0, G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID());
-                        manager->FillNtupleDColumn(2,1,theTrack->GetTotalEnergy()/(MeV));
-                        manager->FillNtupleDColumn(2,2,weight);
-                        manager->FillNtupleSColumn(2,3,endPoint->GetPhysicalVolume()->GetName());
                         G4ThreeVector NRF_loc = theTrack->GetPosition();
-                        manager->FillNtupleDColumn(2,4, NRF_loc.z()/(cm));
-                        manager->AddNtupleRow(2);
+                        khisto->FillNRF(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(), theTrack->GetTotalEnergy()/(MeV), weight,
+                                        OutputCodes::GetVolumeCode(endPoint->GetPhysicalVolume()), NRF_loc.z()/(cm), theTrack->GetGlobalTime());
+                        kevent->NRFEvent(theTrack->GetTotalEnergy()/(MeV), weight, theTrack->GetGlobalTime());
                         if(weightHisto)
                         {
-                                manager->FillH1(8, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(8, theTrack->GetKineticEnergy()/(MeV), weight);
                         }
                 }
         }
@@ -145,15 +166,13 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                    && previousStep_VolumeName.compare(0, 4, "Chop") != 0
                    && theTrack->GetParticleDefinition() == G4Gamma::Definition())
                 {
-                        manager->FillNtupleDColumn(0,0, theTrack->GetKineticEnergy()/(MeV)); // not weighting chopper
-                        manager->FillNtupleDColumn(0,1, weight);
-                        manager->FillNtupleIColumn(0,2,G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID());
-                        manager->AddNtupleRow(0);
+                        // not weighting chopper
+                        khisto->FillChopIn(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(), theTrack->GetKineticEnergy()/(MeV), weight);
                         if(weightHisto)
-                                manager->FillH1(0, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(0, theTrack->GetKineticEnergy()/(MeV), weight);
                         if(bremTest)
                         {
-                                manager->FillH1(0, theTrack->GetKineticEnergy()/(MeV));
+                                khisto->FillH1(0, theTrack->GetKineticEnergy()/(MeV));
                                 theTrack->SetTrackStatus(fStopAndKill); // kill track only intersted in incident chopper Data 
                                 krun->AddStatusKilled();
                         }
@@ -165,13 +184,9 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                 if(nextStep_VolumeName.compare(0,4,"Chop") != 0
                    && previousStep_VolumeName.compare(0,4,"Chop") == 0)
                 {
-                        manager->FillNtupleDColumn(1,0, theTrack->GetKineticEnergy()/(MeV));
-                        manager->FillNtupleDColumn(1,1, weight);
-                        manager->FillNtupleIColumn(1,2,G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID());
-                        manager->FillNtupleIColumn(1,3,isNRF);
-                        manager->AddNtupleRow(1);
+                        khisto->FillChopOut(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(), theTrack->GetKineticEnergy()/(MeV), weight, isNRF);
                         if(weightHisto)
-                                manager->FillH1(1, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(1, theTrack->GetKineticEnergy()/(MeV), weight);
                 }
         }
 
@@ -186,7 +201,7 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                 {
                         if(theTrack->GetParticleDefinition() == G4Gamma::Definition() && !isNRF) // only add non NRF Gammas 
                         {
-                                manager->FillH1(2, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(2, theTrack->GetKineticEnergy()/(MeV), weight);
                                 //manager->FillNtupleDColumn(6,0, theTrack->GetKineticEnergy()/(MeV));
                                 //manager->FillNtupleDColumn(6,1, weight);
                                 //manager->FillNtupleSColumn(6,2, CPName);
@@ -202,7 +217,7 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                         // NRF Incident Interrogation Object
                         if(isNRF && drawNRFDataFlag) // only add NRF 
                         {
-                                manager->FillH1(3, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(3, theTrack->GetKineticEnergy()/(MeV), weight);
                         }
                 }
                 // Exiting Interrogation Object
@@ -210,10 +225,10 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                    && previousStep_VolumeName.compare(0,6,"IntObj") == 0)
                 {
                         if(theTrack->GetParticleDefinition() == G4Gamma::Definition() && !isNRF)
-                                manager->FillH1(4, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(4, theTrack->GetKineticEnergy()/(MeV), weight);
                         // NRF Exiting Interrogation Object
                         if(isNRF && drawNRFDataFlag)
-                                manager->FillH1(5, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(5, theTrack->GetKineticEnergy()/(MeV), weight);
                 }
         }
 
@@ -226,10 +241,10 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                 if(nextStep_VolumeName.compare(0, 5,"Water") == 0
                    && previousStep_VolumeName.compare(0, 5, "Water") != 0)
                 {
-                        manager->FillH1(6, theTrack->GetKineticEnergy()/(MeV),weight);
+                        khisto->FillH1(6, theTrack->GetKineticEnergy()/(MeV),weight);
                         // NRF Incident Water Tank
                         if(isNRF && drawNRFDataFlag)
-                                manager->FillH1(7, theTrack->GetKineticEnergy()/(MeV), weight);
+                                khisto->FillH1(7, theTrack->GetKineticEnergy()/(MeV), weight);
                 }
         }
 
@@ -249,7 +264,7 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                 {
                         if(drawCherenkovDataFlag)
                         {
-                                kevent->CherenkovEnergy(theTrack->GetKineticEnergy()/(MeV));
+                                kevent->CherenkovEnergy(theTrack->GetKineticEnergy()/(MeV), weight);
                                 kevent->CherenkovSecondaries(secondaries->size());
                                 kevent->CherenkovTime(theTrack->GetGlobalTime());
                         }
@@ -306,97 +321,53 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep)
                                 if(opProc && !bremTest)
                                 {
                                         theStatus = opProc->GetStatus();
+                                        // the efficiency of pre-accepted photons was sampled at creation, the boundary
+                                        // process draws it again and calls the failures Absorption
+                                        if(theStatus == Absorption && trackInformation::IsPreAccepted(theTrack))
+                                                theStatus = Detection;
+
+                                        procCount = OutputCodes::GetDetProcessCode(theStatus);
 
-                                        if(theStatus == Transmission)
-                                        {
-                                                procCount = "Trans";
-                                        }
-                                        else if(theStatus == FresnelRefraction)
-                                        {
-                                                procCount = "Refr";
-                                        }
-                                        else if (theStatus == TotalInternalReflection)
-                                        {
-                                                procCount = "Int_Refl";
-                                        }
-                                        else if (theStatus == LambertianReflection)
-                                        {
-                                                procCount = "Lamb";
-                                        }
-                                        else if (theStatus == LobeReflection)
-                                        {
-                                                procCount = "Lobe";
-                                        }
-                                        else if (theStatus == SpikeReflection)
-                                        {
-                                                procCount = "Spike";
-                                        }
-                                        else if (theStatus == BackScattering)
-                                        {
-                                                procCount = "BackS";
-                                        }
-                                        else if (theStatus == Absorption)
-                                        {
-                                                procCount = "Abs";
-                                        }
                                         // Keep track of detected photons
-                                        else if (theStatus == Detection)
+                                        // PMTs saturated by /optical/maxPE record no more photoelectrons this event
+                                        if(theStatus == Detection && theParticle->GetKineticEnergy()/(eV) < 10.0
+                                           && kstacking->AcceptDetection(endPoint->GetTouchable(), endPoint->GetTouchable()->GetCopyNumber(1)))
                                         {
-                                                if(theParticle->GetKineticEnergy()/(eV) < 10.0) 
-                                                {
-                                                        procCount = "Det";
-                                                        manager->FillNtupleIColumn(4,0,G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID());
-                                                        manager->FillNtupleDColumn(4,1, theParticle->GetKineticEnergy()/(MeV));
-                                                        manager->FillNtupleDColumn(4,2, weight);
-                                                        G4String creatorProcess;
-                                                        
-                                                        if(theTrack->GetCreatorProcess() !=0)
-                                                                creatorProcess = theTrack->GetCreatorProcess()->GetProcessName();
-                                                        else
-                                                                creatorProcess = "Brem";
-                                                        
-                                                        manager->FillNtupleSColumn(4,3, creatorProcess);
-                                                        manager->FillNtupleDColumn(4,4, theTrack->GetGlobalTime()); // time units is nanoseconds
-                                                        manager->AddNtupleRow(4); 
-                                                        manager->FillH1(11, theParticle->GetKineticEnergy()/(eV), weight);
-                                                }
-                                        }
-                                        else if (theStatus == NotAtBoundary)
-                                        {
-                                                procCount = "NotAtBoundary";
-                                        }
-                                        else if (theStatus == SameMaterial)
-                                        {
-                                                procCount = "SameMaterial";
-                                        }
-                                        else if (theStatus == StepTooSmall)
-                                        {
-                                                procCount = "SteptooSmall";
-                                        }
-                                        else if (theStatus == NoRINDEX)
-                                        {
-                                                procCount = "NoRINDEX";
-                                        }
-                                        else
-                                        {
-                                                procCount = "noStatus";
+                                                // creator process code 0 is the beam ("Brem"), time units is nanoseconds
+                                                khisto->FillDet(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(), theParticle->GetKineticEnergy()/(MeV), weight,
+                                                                OutputCodes::GetProcessCode(theTrack->GetCreatorProcess()), theTrack->GetGlobalTime());
+                                                khisto->FillH1(11, theParticle->GetKineticEnergy()/(eV), weight);
+                                                const G4VProcess* creator = theTrack->GetCreatorProcess();
+                                                if(creator && (creator->GetProcessName() == "Cerenkov" || creator->GetProcessName() == "Scintillation"))
+                                                        kevent->DetectedEvent(theTrack->GetGlobalTime());
                                         }
                                         // Keep track of Detector Process Data
                                         if(drawDetDataFlag && !bremTest)
                                         {
-                                                manager->FillNtupleIColumn(5,0,G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID());
-                                                manager->FillNtupleDColumn(5,1, theParticle->GetKineticEnergy()/(MeV));
-                                                manager->FillNtupleDColumn(5,2, weight);
-                                                manager->FillNtupleSColumn(5,3, procCount);
-                                                manager->AddNtupleRow(5);
+                                                khisto->FillIncDet(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(), theParticle->GetKineticEnergy()/(MeV), weight, procCount);
                                                 
                                                 if(weightHisto)
-                                                        manager->FillH1(10,theParticle->GetKineticEnergy()/(MeV), weight);
+                                                        khisto->FillH1(10,theParticle->GetKineticEnergy()/(MeV), weight);
                                         } // for if keeping track of detector process data
 
                                 } // for if opProc
                         } // for for loop
                 } // for if statement if first time in photocathode
         } // for if at boundary
+
+        // weight window split copies start from the volume boundary with the track. They are added after
+        // the secondaries of the step were counted so they are not taken for secondaries of the step
+        for(G4int i=1; i<nSplit; ++i)
+        {
+                G4Track* copy = new G4Track(new G4DynamicParticle(*theTrack->GetDynamicParticle()),
+                                            theTrack->GetGlobalTime(), theTrack->GetPosition());
+                copy->SetWeight(theTrack->GetWeight());
+                copy->SetParentID(theTrack->GetParentID());
+                copy->SetCreatorProcess(theTrack->GetCreatorProcess());
+                copy->SetTouchableHandle(endPoint->GetTouchableHandle());
+                if(theTrack->GetUserInformation())
+                        copy->SetUserInformation(new trackInformation(*(trackInformation*)theTrack->GetUserInformation()));
+                const_cast<G4Step*>(aStep)->GetfSecondary()->push_back(copy);
+        }
           //std::cout << "SteppingAction::UserSteppingAction()-> Ending!" <<std::endl;
 } // end of user stepping action function
@@ -22,67 +22,43 @@
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 ///////////////////////////////////////////////////////////////////////////////
 
-
 #include "WeightHisto.hh"
+#include "HistoNames.hh"
 
 extern G4String root_output_name;
 extern G4String gOutName;
 
-WeightHisto::WeightHisto(G4double Em)
-        :Emax(Em)
+WeightHisto::WeightHisto(G4double Em, const std::vector<G4double>& binEdges, G4int nThreads)
+        :fout(0), Emax(Em), edges(binEdges)
 {
         time_start = std::time(&timer);
-        std::string cher_to_nrf_infile = gOutName + "_NRF_to_Cher.root";
-        std::string to_det_infile = gOutName + "_NRF_to_Cher_to_Det.root";
+        // the event correlations are written to the run output by EventAction
+        infile = gOutName + ".root";
         fileOut = gOutName + "_WeightedHisto.root";
                 
-        if(gSystem->AccessPathName(cher_to_nrf_infile.c_str()))
+        if(gSystem->AccessPathName(infile.c_str()))
         {
-                G4cerr << "WeightHisto::WeightHisto -> File: " << cher_to_nrf_infile << " NOT FOUND!" << G4endl;
-                std::cerr << "WeightHisto::WeightHisto -> File: " << cher_to_nrf_infile << " NOT FOUND!" << std::endl;
+                G4cerr << "WeightHisto::WeightHisto -> File: " << infile << " NOT FOUND!" << G4endl;
+                std::cerr << "WeightHisto::WeightHisto -> File: " << infile << " NOT FOUND!" << std::endl;
                 exit(1);
         }
         else
         {
-                f = new TFile(cher_to_nrf_infile.c_str());
-                G4cout << "WeightHisto::WeightHisto -> File: " << cher_to_nrf_infile << " exists!" << G4endl;
+                f = new TFile(infile.c_str());
+                G4cout << "WeightHisto::WeightHisto -> File: " << infile << " exists!" << G4endl;
         }
 
-        if(gSystem->AccessPathName(to_det_infile.c_str()))
+        if(!f->GetKey("nrf_to_cher_tree") || !f->GetKey("nrf_to_cher_to_det_tree"))
         {
-                G4cerr << "WeightHisto::WeightHisto -> File: " << to_det_infile << " NOT FOUND!" << G4endl;
-                std::cerr << "WeightHisto::WeightHisto -> File: " << to_det_infile << " NOT FOUND!" << std::endl;
+                G4cerr << "ERROR: WeightHisto::WeightHisto --> Event correlations not found in " << infile << ". Run with -e true." << G4endl;
+                std::cerr << "ERROR: WeightHisto::WeightHisto --> Event correlations not found in " << infile << ". Run with -e true." << std::endl;
                 exit(1);
         }
-        else
-        {
-                f1 = new TFile(to_det_infile.c_str());
-                G4cout << "WeightHisto::WeightHisto -> File: " << to_det_infile << " exists!" << G4endl;
-        }
 
-        bool confirm = f->cd();
-        if(confirm)
-        {
-                f->GetObject("nrf_to_cher_tree",nrf_to_cher_tree);
-        }
-        else
+        if(nThreads > 0)
         {
-                G4cerr << "ERROR: WeightHisto::WeightHisto --> Failure to Change into NRF to Cher Directory!" << G4endl;
-                std::cerr << "ERROR: WeightHisto::WeightHisto --> Failure to Change into NRF to Cher Directory!" << std::endl;
-                exit(1);
-        }
-
-        confirm = f1->cd();
-
-        if(confirm)
-        {
-                f1->GetObject("nrf_to_cher_to_det_tree",nrf_to_cher_to_det_tree);
-        }
-        else
-        {
-                G4cerr << "ERROR: WeightHisto::WeightHisto --> Failure to Change into NRF to Cher to Det Directory!" << G4endl;
-                std::cerr << "ERROR: WeightHisto::WeightHisto --> Failure to Change into NRF to Cher to Det Directory!" << std::endl;
-                exit(1);
+                ROOT::EnableImplicitMT(nThreads);
+                G4cout << "WeightHisto::WeightHisto --> Using " << nThreads << " analysis threads." << G4endl;
         }
         
         G4cout << "WeightHisto::WeightHisto --> Objects Obtained." << G4endl;
@@ -93,67 +69,56 @@ WeightHisto::~WeightHisto()
 {
 }
 
-// ******************************************************************************************************************************** //
-// Fill NRF that Lead to Cherenkov Weighted Histogram for NRF Energies and Cherenkov Energies
-// ******************************************************************************************************************************** //
+ROOT::RDataFrame WeightHisto::MakeDataFrame(const char* name)
+{
+#if defined(MANTIS_RNTUPLE) && ROOT_VERSION_CODE < ROOT_VERSION(6,32,0)
+        // RDataFrame only detects RNTuples by itself from ROOT 6.32
+        if(TString(f->GetKey(name)->GetClassName()).Contains("RNTuple"))
+                return ROOT::RDF::Experimental::FromRNTuple(name, infile);
+#endif
+        return ROOT::RDataFrame(name, infile);
+}
 
-void WeightHisto::Fill_NRF_to_Cherenkov()
+ROOT::RDF::TH1DModel WeightHisto::Model(const char* name, const char* title) const
 {
-        f->cd();
-        // Check if file exists 
-        if(nrf_to_cher_tree == NULL)
+        // use the run binning so the weighted spectra line up with the run histograms
+        if(edges.size() > 1)
+                return ROOT::RDF::TH1DModel(name, title, edges.size()-1, edges.data());
+        return ROOT::RDF::TH1DModel(name, title, 100000, 0., Emax);
+}
+
+void WeightHisto::FillPair(const char* name, const char* energy1, const char* weight1, const char* energy2, const char* weight2,
+                           const ROOT::RDF::TH1DModel& model1, const ROOT::RDF::TH1DModel& model2)
+{
+        ROOT::RDataFrame df = MakeDataFrame(name);
+        auto n_entries = df.Count();
+        auto h1 = df.Histo1D(model1, energy1, weight1);
+        auto h2 = df.Histo1D(model2, energy2, weight2);
+        // accessing a result runs the single event loop that fills all booked results
+        G4cout << "WeightHisto::FillPair -> " << name << " Entries: " << *n_entries << G4endl;
+
+        bool confirm = fout->cd();
+        if(!confirm)
         {
-                G4cerr << "WeightHisto::Fill_NRF_to_Cherenkov -> NRF to Cherenkov Tree Empty. Exiting..." << G4endl;
-                std::cerr << "WeightHisto::Fill_NRF_to_Cherenkov -> NRF to Cherenkov Tree Empty. Exiting..." << std::endl;
+                G4cerr << "ERROR: WeightHisto::FillPair --> Failure to change into OutFile Directory!" << G4endl;
+                std::cerr << "ERROR: WeightHisto::FillPair --> Failure to change into OutFile Directory!" << std::endl;
                 exit(1);
         }
+        h1->Write();
+        h2->Write();
+}
 
-        // Grab data from in file 
-        G4int n_entries = nrf_to_cher_tree->Draw("NRF_Energy:NRF_Weight","","goff");
-        G4cout << "WeightHisto::Fill_NRF_to_Cherenkov -> NRF to Cherenkov Tree Entries: " << n_entries << G4endl;
-
-        G4double *nrfcherNRFEnergy = nrf_to_cher_tree->GetVal(0);
-        G4double *nrfcherNRFWeight = nrf_to_cher_tree->GetVal(1);
-
-        nrf_to_cher_tree->Draw("Cher_Energy:Cher_Weight","","goff");
-
-        G4double *nrfcherCherEnergy = nrf_to_cher_tree->GetVal(0);
-        G4double *nrfcherCherWeight = nrf_to_cher_tree->GetVal(1);
-        
+// ******************************************************************************************************************************** //
+// Fill NRF that Lead to Cherenkov Weighted Histogram for NRF Energies and Cherenkov Energies
+// ******************************************************************************************************************************** //
 
+void WeightHisto::Fill_NRF_to_Cherenkov()
+{
         // Create Out File 
         fout = new TFile(fileOut.c_str(), "recreate");
-        bool confirm = fout->cd();
-        wNRF_NRF_to_Cher = new TH1D("wNRF_NRF_to_Cher","Weighted NRF Spectrum that Lead to Cherenkov",100000, 0., Emax);
-        wCher_NRF_to_Cher = new TH1D("wCher_NRF_to_Cher","Weighted Cherenkov Spectrum caused by NRF",100000,0.,Emax);
-        
-        // Fill Out Trees  
-        for(int i=0; i<n_entries; ++i)
-        {
-                wNRF_NRF_to_Cher->Fill(nrfcherNRFEnergy[i], nrfcherNRFWeight[i]);
-        }
-
-        for(int i=0; i<n_entries; ++i)
-        {
-                wCher_NRF_to_Cher->Fill(nrfcherCherEnergy[i], nrfcherCherWeight[i]);
-        }
-        
-        // Write to outfile 
-        if(confirm)
-        {
-                if(nrf_to_cher_tree != NULL)
-                {
-                        wNRF_NRF_to_Cher->Write();
-                        wCher_NRF_to_Cher->Write();
-                }
-        }
-        else
-        {
-                G4cerr << "ERROR: WeightHisto::Fill_NRF_to_Cherenkov --> Failure to change into NRF to Cherenkov OutFile Directory!" << G4endl;
-                std::cerr << "ERROR: WeightHisto::Fill_NRF_to_Cherenkov --> Failure to change into NRF to Cherenkov OutFile Directory!" << std::endl;
-                exit(1);
-        }
-                
+        FillPair("nrf_to_cher_tree", "NRF_Energy", "NRF_Weight", "Cher_Energy", "Cher_Weight",
+                 Model(HistoNames::kWeighted[0],"Weighted NRF Spectrum that Lead to Cherenkov"),
+                 Model(HistoNames::kWeighted[1],"Weighted Cherenkov Spectrum caused by NRF"));
 
         G4cout << "WeightHisto::Fill_NRF_to_Cherenkov --> Complete." << G4endl;
         std::cout << "WeightHisto::Fill_NRF_to_Cherenkov --> Complete." << std::endl;
@@ -165,61 +130,17 @@ void WeightHisto::Fill_NRF_to_Cherenkov()
 
 void WeightHisto::Fill_to_Det()
 {
-        f1->cd();
-        // Check if File Exists 
-        if(nrf_to_cher_to_det_tree == NULL)
-        {
-                G4cout << "WeightHisto::Fill_to_Det -> To Detection Tree Empty. Exiting..." << G4endl;
-                std::cout << "WeightHisto::Fill_to_Det -> To Detection Tree Empty. Exiting..." << std::endl;
-                exit(1);
-        }
-        
-        // Grab data from in file 
-
-        G4double n_entries = nrf_to_cher_to_det_tree->Draw("EnergyNRF:WeightNRF","","goff");
-        G4double *nrfcherdetNRFEnergy = nrf_to_cher_to_det_tree->GetVal(0);
-        G4double *nrfcherdetNRFWeight = nrf_to_cher_to_det_tree->GetVal(1);  
-
-        nrf_to_cher_to_det_tree->Draw("EnergyCher:WeightCher","","goff");
-        G4double *nrfcherdetCherEnergy = nrf_to_cher_to_det_tree->GetVal(0);
-        G4double *nrfcherdetCherWeight = nrf_to_cher_to_det_tree->GetVal(1);
-        
-        // Change Directory to Out File 
-        bool confirm = fout->cd();
-        wNRF_to_Det = new TH1D("wNRF_to_Det","Weighted NRF Energy Spectrum that Lead to Cherenkov that Lead to Detection",100000,0.,Emax);
-        wCher_to_Det = new TH1D("wCher_to_Det","Weighted Cherenkov Energy Spectrum Caused by NRF that Lead to Detection", 100000, 0., Emax);
-
-        // Fill Out Trees 
-        for(int i=0; i<n_entries; ++i)
-        {
-                wNRF_to_Det->Fill(nrfcherdetNRFEnergy[i], nrfcherdetNRFWeight[i]);
-        }
-
-        for(int i=0; i<n_entries; ++i)
-        {
-                wCher_to_Det->Fill(nrfcherdetCherEnergy[i], nrfcherdetCherWeight[i]);
-        }
-        
-        // Write to outfile 
-        if(confirm)
-        {
-                if(nrf_to_cher_to_det_tree != NULL)
-                {
-                        wNRF_to_Det->Write();
-                        wCher_to_Det->Write();
-                } 
-        }
-        else
-        {
-                G4cerr << "ERROR: WeightHisto::Fill_to_Det -> Fail to change into Output Directory" << G4endl;
-                std::cerr << "ERROR: WeightHisto::Fill_to_Det -> Fail to change into Output Directory" << std::endl;
-                exit(1);
-        }
+        if(!fout)
+                fout = new TFile(fileOut.c_str(), "recreate");
+        FillPair("nrf_to_cher_to_det_tree", "EnergyNRF", "WeightNRF", "EnergyCher", "WeightCher",
+                 Model(HistoNames::kWeighted[2],"Weighted NRF Energy Spectrum that Lead to Cherenkov that Lead to Detection"),
+                 Model(HistoNames::kWeighted[3],"Weighted Cherenkov Energy Spectrum Caused by NRF that Lead to Detection"));
                 
         G4cout << "WeightHisto::Fill_to_Det --> Complete!" << G4endl;
         std::cout << "WeightHisto::Fill_to_Det --> Complete!" << std::endl;
         
         fout->Close();
+        f->Close();
         G4cout << "WeightHisto::Fill_to_Det -> Weighted Histograms written to: " << fileOut << G4endl;
         time_end = std::time(&timer2);
         G4cout << "WeightHisto::Fill_to_Det -> Weighting Histos took: " << std::difftime(time_end,time_start) << " seconds!" << G4endl;
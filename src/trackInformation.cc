@@ -0,0 +1,51 @@
+//
+// ********************************************************************
+// * DISCLAIMER                                                       *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.                                                             *
+// *                                                                  *
+// * By copying,  distributing  or modifying the Program (or any work *
+// * based  on  the Program)  you indicate  your  acceptance of  this *
+// * statement, and all its terms.                                    *
+// ********************************************************************
+//
+//
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Author:
+// Jacob E Bickus, 2021
+// MIT, NSE
+// jbickus@mit.edu
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+///////////////////////////////////////////////////////////////////////////////
+
+#include "trackInformation.hh"
+#include "G4ios.hh"
+
+trackInformation::trackInformation()
+{
+        preAccepted = false;
+}
+
+trackInformation::~trackInformation()
+{
+}
+
+void trackInformation::SetPreAccepted(G4bool x)
+{
+        preAccepted = x;
+}
+
+G4bool trackInformation::IsPreAccepted(const G4Track* aTrack)
+{
+        trackInformation* info = dynamic_cast<trackInformation*>(aTrack->GetUserInformation());
+        return info && info->GetPreAccepted();
+}
+
+void trackInformation::Print() const
+{
+        G4cout << "trackInformation: pre-accepted " << preAccepted << G4endl;
+}